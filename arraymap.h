@@ -7,11 +7,13 @@
 #ifndef ARRAYMAP_H
 #define ARRAYMAP_H
 
+#include <utility>
 #include "map.h"
+#include "interface.h"
 #include "arrayseq.h"
 
 template <typename K, typename V>
-class ArrayMap : public Map<K, V>
+class ArrayMap final : public Map<K, V>
 {
 public:
     // Returns the number of key-value pairs in the map
@@ -33,6 +35,19 @@ public:
     // collection. Insert does not check if the key is present.
     void insert(const K &key, const V &value);
 
+    // Same as above, moving the key and value into the collection
+    // instead of copying them.
+    void insert(K &&key, V &&value);
+
+    // Adds the key with a value constructed in place from the
+    // arguments (forwarded to V's constructor) if the key is not
+    // already in the collection. Returns true if the pair was added,
+    // and false (without using the arguments) otherwise.
+    template <typename... Args>
+    bool try_emplace(const K &key, Args &&...args);
+    template <typename... Args>
+    bool try_emplace(K &&key, Args &&...args);
+
     // Shrinks the collection by removing the key-value pair with the
     // given key. Does not modify the collection if the collection does
     // not contain the key. Throws out_of_range if the given key is not
@@ -50,8 +65,15 @@ public:
     ArraySeq<K> sorted_keys() const;
 
 private:
-    // implemented as a resizable array of (key-value) pairs
-    ArraySeq<std::pair<K, V>> seq;
+    // helper for both try_emplace overloads (KArg is const K& or K)
+    template <typename KArg, typename... Args>
+    bool emplace_unique(KArg &&key, Args &&...args);
+
+    // implemented as parallel resizable arrays of keys and values
+    // (the value for keys[i] is values[i]), so key scans run over
+    // contiguous keys
+    ArraySeq<K> keys;
+    ArraySeq<V> values;
 };
 
 // TODO: Implement the ArrayMap functions below. Note that you do not
@@ -60,7 +82,6 @@ private:
 //       move assignment operator for this version of Map. Instead,
 //       the default C++ implementations are sufficient.
 
-#endif
 
 // Implimentation
 
@@ -68,14 +89,14 @@ private:
 template <typename K, typename V>
 int ArrayMap<K, V>::size() const
 {
-    return seq.size();
+    return keys.size();
 }
 
 // Tests if the map is empty
 template <typename K, typename V>
 bool ArrayMap<K, V>::empty() const
 {
-    return seq.empty();
+    return keys.empty();
 }
 
 // Allows values associated with a key to be updated. Throws
@@ -83,20 +104,10 @@ bool ArrayMap<K, V>::empty() const
 template <typename K, typename V>
 V &ArrayMap<K, V>::operator[](const K &key)
 {
-    if (contains(key))
-    {
-        for (int i = 0; i < seq.size(); ++i)
-        {
-            if (seq[i].first == key)
-            {
-                return seq[i].second;
-            }
-        }
-    }
-    else
-    {
+    int index = keys.index_of(key);
+    if (index < 0)
         throw std::out_of_range("Out of range in the [] non-const");
-    }
+    return values.at_unchecked(index);
 }
 
 // Returns the value for a given key. Throws out_of_range if the
@@ -104,18 +115,10 @@ V &ArrayMap<K, V>::operator[](const K &key)
 template <typename K, typename V>
 const V &ArrayMap<K, V>::operator[](const K &key) const
 {
-    if (contains(key))
-    {
-        for (int i = 0; i < seq.size(); ++i)
-        {
-            if (seq[i].first == key)
-                return seq[i].second;
-        }
-    }
-    else
-    {
+    int index = keys.index_of(key);
+    if (index < 0)
         throw std::out_of_range("Out of range in the [] const");
-    }
+    return values.at_unchecked(index);
 }
 
 // Extends the collection by adding the given key-value
@@ -124,7 +127,46 @@ const V &ArrayMap<K, V>::operator[](const K &key) const
 template <typename K, typename V>
 void ArrayMap<K, V>::insert(const K &key, const V &value)
 {
-    seq.insert({key, value}, seq.size());
+    keys.insert(key, keys.size());
+    values.insert(value, values.size());
+}
+
+// Extends the collection by moving the given key-value pair in.
+// Assumes the key being added is not present in the collection.
+template <typename K, typename V>
+void ArrayMap<K, V>::insert(K &&key, V &&value)
+{
+    keys.insert(std::move(key), keys.size());
+    values.insert(std::move(value), values.size());
+}
+
+// Adds the key with a value constructed in place from the arguments
+// if the key is not already in the collection.
+template <typename K, typename V>
+template <typename... Args>
+bool ArrayMap<K, V>::try_emplace(const K &key, Args &&...args)
+{
+    return emplace_unique(key, std::forward<Args>(args)...);
+}
+
+template <typename K, typename V>
+template <typename... Args>
+bool ArrayMap<K, V>::try_emplace(K &&key, Args &&...args)
+{
+    return emplace_unique(std::move(key), std::forward<Args>(args)...);
+}
+
+// Returns false if the key is in the collection, otherwise adds the
+// key (forwarded) with a value constructed from the arguments.
+template <typename K, typename V>
+template <typename KArg, typename... Args>
+bool ArrayMap<K, V>::emplace_unique(KArg &&key, Args &&...args)
+{
+    if (keys.index_of(key) >= 0)
+        return false;
+    keys.emplace(keys.size(), std::forward<KArg>(key));
+    values.emplace(values.size(), std::forward<Args>(args)...);
+    return true;
 }
 
 // Shrinks the collection by removing the key-value pair with the
@@ -134,23 +176,11 @@ void ArrayMap<K, V>::insert(const K &key, const V &value)
 template <typename K, typename V>
 void ArrayMap<K, V>::erase(const K &key)
 {
-    if (contains(key))
-    {
-        int index = -1;
-        for (int i = 0; i < seq.size(); ++i)
-        {
-            if (seq[i].first == key)
-            {
-                index = i;
-                break;
-            }
-        }
-        seq.erase(index);
-    }
-    else
-    {
+    int index = keys.index_of(key);
+    if (index < 0)
         throw std::out_of_range("Out of range in the [] const");
-    }
+    keys.erase(index);
+    values.erase(index);
 }
 
 // Returns true if the key is in the collection, and false
@@ -158,25 +188,21 @@ void ArrayMap<K, V>::erase(const K &key)
 template <typename K, typename V>
 bool ArrayMap<K, V>::contains(const K &key) const
 {
-    for (int i = 0; i < seq.size(); ++i)
-    {
-        if (seq[i].first == key)
-            return true;
-    }
-    return false;
+    return keys.contains(key);
 }
 
 // Returns the keys k in the collection such that k1 <= k <= k2
 template <typename K, typename V>
 ArraySeq<K> ArrayMap<K, V>::find_keys(const K &k1, const K &k2) const
 {
+    // only the matching keys are copied and sorted
     ArraySeq<K> new_seq;
-    ArraySeq<K> keys = sorted_keys();
-    for (int i = 0; i < keys.size(); ++i)
+    for (const K &k : keys)
     {
-        if (keys[i] >= k1 && keys[i] <= k2)
-            new_seq.insert(keys[i], new_seq.size());
+        if (k >= k1 && k <= k2)
+            new_seq.insert(k, new_seq.size());
     }
+    new_seq.merge_sort();
     return new_seq;
 }
 
@@ -184,10 +210,17 @@ ArraySeq<K> ArrayMap<K, V>::find_keys(const K &k1, const K &k2) const
 template <typename K, typename V>
 ArraySeq<K> ArrayMap<K, V>::sorted_keys() const
 {
-    ArraySeq<K> new_seq;
-    for (int i = 0; i < seq.size(); ++i)
-        new_seq.insert(seq[i].first, new_seq.size());
-        
-    new_seq.merge_sort();
+    ArraySeq<K> new_seq = keys;
+    // integer keys are radix sorted, anything else is merge sorted
+    if constexpr (radix_traits<K>::sortable)
+        new_seq.sort();
+    else
+        new_seq.parallel_merge_sort();
     return new_seq;
-}
\ No newline at end of file
+}
+
+static_assert(is_map<ArrayMap<int, int>, int, int>::value and
+              has_static_dispatch<ArrayMap<int, int>>::value,
+              "ArrayMap must satisfy the Map interface statically");
+
+#endif
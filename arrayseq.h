@@ -14,11 +14,66 @@
 #include <ostream>
 #include <random>
 #include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <memory>
+#include <new>
+#include <iterator>
+#include <thread>
+#include <vector>
 #include "sequence.h"
+#include "simdfind.h"
+#include "interface.h"
 
 
+// True for element types that ArraySeq may shift with a raw memmove.
+// std::pair is never trivially copyable (its assignment operators are
+// user provided) but a pair of trivially copyable members is still
+// safe to move bytewise, which covers the maps' key-value pairs.
 template<typename T>
-class ArraySeq : public Sequence<T>
+struct is_bitwise_movable : std::is_trivially_copyable<T> {};
+
+template<typename A, typename B>
+struct is_bitwise_movable<std::pair<A, B>>
+  : std::integral_constant<bool, is_bitwise_movable<A>::value and
+                                 is_bitwise_movable<B>::value> {};
+
+
+// Describes how ArraySeq::sort can radix sort an element type: for
+// integral types (other than bool) the element is its own key, and for
+// std::pair the key is an integral first member. The key type is
+// exposed as key_type and extracted with key().
+template<typename T, typename = void>
+struct radix_traits
+{
+  static const bool sortable = false;
+};
+
+template<typename T>
+struct radix_traits<T, typename std::enable_if<
+  std::is_integral<T>::value and !std::is_same<T, bool>::value>::type>
+{
+  static const bool sortable = true;
+  static const bool pair = false;
+  using key_type = T;
+  static key_type key(const T& elem) { return elem; }
+};
+
+template<typename A, typename B>
+struct radix_traits<std::pair<A, B>, typename std::enable_if<
+  std::is_integral<A>::value and !std::is_same<A, bool>::value>::type>
+{
+  static const bool sortable = true;
+  static const bool pair = true;
+  using key_type = A;
+  static key_type key(const std::pair<A, B>& elem) { return elem.first; }
+};
+
+template<typename T>
+class ArraySeq final : public Sequence<T>
 {
 public:
 
@@ -29,6 +84,11 @@ public:
   // Copy constructor
   ArraySeq(const ArraySeq& rhs);
 
+  // Range constructor, copies the elements in [first, last)
+  template<typename InputIt,
+           typename = typename std::iterator_traits<InputIt>::iterator_category>
+  ArraySeq(InputIt first, InputIt last);
+
   // Move constructor
   ArraySeq(ArraySeq&& rhs);
 
@@ -55,48 +115,192 @@ public:
   // sequence. Throws out_of_range if index is invalid.
   virtual const T& operator[](int index) const;
 
+  // Returns the element at the index without checking the index (not
+  // virtual, so it can be inlined into tight loops). The index must
+  // be valid.
+  T& at_unchecked(int index);
+  const T& at_unchecked(int index) const;
+
+  // Returns a pointer to the underlying contiguous elements
+  T* data();
+  const T* data() const;
+
+  // Contiguous (pointer) iterators over the elements, for range-for
+  // loops and <algorithm>
+  T* begin();
+  T* end();
+  const T* begin() const;
+  const T* end() const;
+  const T* cbegin() const;
+  const T* cend() const;
+
   // Extends the sequence by inserting the element at the given
   // index. Throws out_of_range if the index is invalid.
   virtual void insert(const T& elem, int index);
 
+  // Same as above, moving the element into the sequence instead of
+  // copying it.
+  virtual void insert(T&& elem, int index);
+
+  // Extends the sequence by constructing an element in place at the
+  // given index from the arguments (forwarded to T's constructor),
+  // and returns a reference to it. Throws out_of_range if the index
+  // is invalid.
+  template<typename... Args>
+  T& emplace(int index, Args&&... args);
+
   // Shrinks the sequence by removing the element at the index in the
   // sequence. Throws out_of_range if index is invalid.
   virtual void erase(int index);
 
+  // Extends the sequence by inserting copies of the elements in
+  // [first, last) starting at the given index, growing the array at
+  // most once and shifting the existing elements once. The range must
+  // not refer into this sequence. Throws out_of_range if the index is
+  // invalid.
+  template<typename InputIt>
+  void insert_range(int index, InputIt first, InputIt last);
+
+  // Extends the sequence by appending copies of the elements in
+  // [first, last). The range must not refer into this sequence.
+  template<typename InputIt>
+  void append(InputIt first, InputIt last);
+
   // Returns true if the element is in the sequence, and false
   // otherwise.
   virtual bool contains(const T& elem) const;
 
+  // Returns the index of the first element equal to elem, or -1 if
+  // the element is not in the sequence. Arithmetic elements are
+  // compared several at a time with SIMD instructions.
+  int index_of(const T& elem) const;
+
+  // Grows the underlying array (if needed) so that it can hold at
+  // least n elements without reallocating.
+  virtual void reserve(int n);
+
+  // Shrinks the underlying array to exactly fit the current elements.
+  void shrink_to_fit();
+
+  // Returns the number of elements the underlying array can hold
+  // before it must be reallocated.
+  int capacity() const;
+
   // Sorts the elements in the sequence using less than equal (<=)
-  // operator. (Not implemented in HW-3)
+  // operator. Integral elements and pairs keyed on an integral type
+  // (see radix_traits) use an LSD radix sort. Everything else uses
+  // introsort: quick sort with median-of-three (or ninther) pivots,
+  // insertion sort for small partitions, and a heap sort fallback
+  // once the recursion gets too deep, so the worst case is
+  // O(n log n).
   virtual void sort(); 
 
   virtual void merge_sort();
 
+  // Merge sorts using up to the given number of threads (0 means one
+  // per hardware core). Halves are sorted in parallel down to
+  // parallel_cutoff elements and the top level merges are split
+  // between the threads by co-ranking. Element comparison and moves
+  // must not throw.
+  void parallel_merge_sort(int threads = 0);
+
   virtual void quick_sort();
+
+  // Heap sorts the whole sequence (the fallback intro sort uses once
+  // its recursion gets too deep). O(n log n) always, but not stable.
+  void heap_sort();
   
 private:
 
-  // resizable array
+  // resizable array (raw storage, only the first count elements are
+  // constructed)
   T* array = nullptr;
 
   // size of list
   int count = 0;
 
   // max capacity of the array
-  int capacity = 0;
+  int cap = 0;
 
   // helper to double the capacity of the array
   void resize();
+
+  // helper to move the elements into a new array of the given
+  // capacity (which must be at least count)
+  void reallocate(int new_cap);
+
+  // helper to grow the array (at least doubling it) so that it can
+  // hold n elements
+  void grow_to(int n);
+
+  // helpers to open (shift_right) or close (shift_left) a one element
+  // hole at the index by moving the elements after it in a single
+  // bulk move (memmove for bitwise movable types). shift_right
+  // constructs the new last element, shift_left leaves the old last
+  // element for the caller to destroy.
+  void shift_right(int index);
+  void shift_left(int index);
   
-  // helper to delete the array list (called by destructor and copy
-  // constructor)
+  // helper to destroy the elements and free the array (called by
+  // destructor and copy assignment)
   void make_empty();
 
-  void merge_sort(int start, int end);
+  // bottom-up merge sort helper for [start, end] using the matching
+  // slots of a raw scratch buffer
+  void merge_sort(int start, int end, T* scratch);
+
+  // helper to merge adjacent sorted runs of the given width from src
+  // into dst, move constructing into dst when it is raw storage
+  template<bool Construct>
+  static void merge_pass(T* src, T* dst, int n, long width);
+
+  // helper to stably merge [first1, last1) and [first2, last2) into
+  // dst, move constructing into dst when it is raw storage
+  template<bool Construct>
+  static void merge_runs(T* first1, T* last1, T* first2, T* last2, T* dst);
+
+  // ranges at or below this size are not split between threads
+  static const int parallel_cutoff = 8192;
+
+  // parallel merge sort helpers for [start, end] using the matching
+  // slots of a raw scratch buffer
+  void parallel_merge_sort(int start, int end, T* scratch, int threads);
+  void parallel_merge(int start, int mid, int end, T* scratch, int threads);
+
+  // helper to return how many of the first k merged elements of the
+  // sorted runs a (na elements) and b (nb elements) come from a
+  static int co_rank(int k, const T* a, int na, const T* b, int nb);
 
   void quick_sort(int start, int end);
 
+  // partitions below this size are insertion sorted
+  static const int insertion_cutoff = 16;
+
+  // introsort helpers (all ranges are inclusive)
+  void intro_sort(int start, int end, int depth_limit);
+  void insertion_sort(int start, int end);
+  void heap_sort(int start, int end);
+  void sift_down(int start, int root, int n);
+
+  // helper to partition [start, end] around a median-of-three (or
+  // ninther for large ranges) pivot, returns the pivot's final index
+  int partition(int start, int end);
+
+  // helper to return the index (a, b, or c) of the median value
+  int median_of_three(int a, int b, int c) const;
+
+  // sequences below this size are introsorted even if radix sortable
+  static const int radix_cutoff = 64;
+
+  // LSD radix sort on 8-bit digits of the radix_traits key, skipping
+  // digits where every key falls in the same bucket
+  void radix_sort();
+
+  // helper to scatter the n elements of src into dst by the digit at
+  // the given shift, using the bucket offsets (advanced in place)
+  template<bool Construct>
+  static void radix_scatter(T* src, T* dst, int n, int shift, int* offsets);
+
 };
 
 
@@ -105,14 +309,21 @@ ArraySeq<T>::ArraySeq()
 {
   array = nullptr;
   count = 0;
-  capacity = 0;
+  cap = 0;
 }
 // Copy constructor
 template <typename T>
   ArraySeq<T>::ArraySeq(const ArraySeq& rhs)
+    : ArraySeq(rhs.array, rhs.array + rhs.count)
+  {
+  }
+
+  // Range constructor, copies the elements in [first, last)
+  template <typename T>
+  template <typename InputIt, typename>
+  ArraySeq<T>::ArraySeq(InputIt first, InputIt last)
   {
-    for(int i = 0; i < rhs.size();++i)
-      insert(rhs[i],i);
+    append(first, last);
   }
 
   // Move constructor
@@ -128,12 +339,10 @@ template <typename T>
   {
     if(this != &rhs)
       {
-        make_empty();
-        if(!rhs.empty())
-          {
-            for(int i = 0; i < rhs.size(); i++)
-              insert(rhs[i], i);
-          }
+        // keep the current array if it is already big enough
+        std::destroy(array, array + count);
+        count = 0;
+        append(rhs.array, rhs.array + rhs.count);
       }
     return *this;
   }
@@ -146,9 +355,10 @@ template <typename T>
     {
         make_empty();
         count = rhs.count;
-        capacity = rhs.capacity;
+        cap = rhs.cap;
         array = rhs.array;
-        rhs.make_empty();
+        rhs.count = 0;
+        rhs.cap = 0;
         rhs.array = nullptr;
     }
 
@@ -160,7 +370,6 @@ template <typename T>
   ArraySeq<T>::~ArraySeq()
   {
     make_empty();
-    delete [] array;
   }
   
   // Returns the number of elements in the sequence
@@ -199,25 +408,113 @@ template <typename T>
     return array[index];
   }
 
+  // Returns the element at the index without checking the index.
+  template <typename T>
+  T& ArraySeq<T>::at_unchecked(int index)
+  {
+    return array[index];
+  }
+
+  template <typename T>
+  const T& ArraySeq<T>::at_unchecked(int index) const
+  {
+    return array[index];
+  }
+
+  // Returns a pointer to the underlying contiguous elements
+  template <typename T>
+  T* ArraySeq<T>::data()
+  {
+    return array;
+  }
+
+  template <typename T>
+  const T* ArraySeq<T>::data() const
+  {
+    return array;
+  }
+
+  // Contiguous (pointer) iterators over the elements
+  template <typename T>
+  T* ArraySeq<T>::begin()
+  {
+    return array;
+  }
+
+  template <typename T>
+  T* ArraySeq<T>::end()
+  {
+    return array + count;
+  }
+
+  template <typename T>
+  const T* ArraySeq<T>::begin() const
+  {
+    return array;
+  }
+
+  template <typename T>
+  const T* ArraySeq<T>::end() const
+  {
+    return array + count;
+  }
+
+  template <typename T>
+  const T* ArraySeq<T>::cbegin() const
+  {
+    return array;
+  }
+
+  template <typename T>
+  const T* ArraySeq<T>::cend() const
+  {
+    return array + count;
+  }
+
   // index. Throws out_of_range if the index is invalid.
   template <typename T>
   void ArraySeq<T>::insert(const T& elem, int index)
+  {
+    emplace(index, elem);
+  }
+
+  // Extends the sequence by moving the element in at the given
+  // index. Throws out_of_range if the index is invalid.
+  template <typename T>
+  void ArraySeq<T>::insert(T&& elem, int index)
+  {
+    emplace(index, std::move(elem));
+  }
+
+  // Constructs an element in place at the given index. Throws
+  // out_of_range if the index is invalid.
+  template <typename T>
+  template <typename... Args>
+  T& ArraySeq<T>::emplace(int index, Args&&... args)
   {
     if(index > count or index < 0)
-      throw std::out_of_range("Out of range in the [] nonconst");
-    
-    if(count + 1 > capacity)
-      resize();
-    
-    T temp1 = array[index];
-    for (int i = index; i < count; ++i)
+      throw std::out_of_range("Out of range in emplace");
+
+    if(index == count and count < cap)
+      new (array + count) T(std::forward<Args>(args)...);
+    else
+    {
+      // the arguments may refer into the array, which the resize and
+      // shift below would invalidate, so the element is built first
+      T elem(std::forward<Args>(args)...);
+      if(count + 1 > cap)
+        resize();
+
+      if(index == count)
+        new (array + count) T(std::move(elem));
+      else
       {
-        T temp2 = array[i+1];
-        array[i+1] = temp1;
-        temp1 = temp2;
+        shift_right(index);
+        array[index] = std::move(elem);
       }
-      array[index] = elem;
-      count++;
+    }
+    count++;
+    return array[index];
   }
 
   // Shrinks the sequence by removing the element at the index in the
@@ -228,55 +525,202 @@ template <typename T>
     if(index >= count or index < 0)
       throw std::out_of_range("Out of range in the [] nonconst");
     
-    for(int i = index; i < count - 1; ++i)
-      array[i] = array[i + 1];
-    
+    shift_left(index);
+    std::destroy_at(array + count - 1);
     --count;
   }
 
-  // Returns true if the element is in the sequence, and false
-  // otherwise.
+  // Extends the sequence by inserting copies of the elements in
+  // [first, last) starting at the given index. Forward ranges are
+  // counted first so the array grows at most once and the existing
+  // elements are shifted once. Throws out_of_range if the index is
+  // invalid.
   template <typename T>
-  bool ArraySeq<T>::contains(const T& elem) const
+  template <typename InputIt>
+  void ArraySeq<T>::insert_range(int index, InputIt first, InputIt last)
   {
-    for(int i = 0; i < count; ++i)
+    if(index > count or index < 0)
+      throw std::out_of_range("Out of range in insert_range");
+
+    using category = typename std::iterator_traits<InputIt>::iterator_category;
+    if constexpr (!std::is_base_of<std::forward_iterator_tag, category>::value)
+    {
+      // single pass range, can only be inserted one at a time
+      for(; first != last; ++first)
+        insert(*first, index++);
+    }
+    else
     {
-      if(array[i] == elem)
+      int n = std::distance(first, last);
+      if(n <= 0)
+        return;
+      if(count + n > cap)
+        grow_to(count + n);
+
+      int tail = count - index;
+      if constexpr (is_bitwise_movable<T>::value)
       {
-        return true;
+        if(tail > 0)
+          std::memmove(static_cast<void*>(array + index + n), array + index,
+                       tail * sizeof(T));
+        std::uninitialized_copy(first, last, array + index);
       }
+      else if(tail > n)
+      {
+        // the last n elements move into raw storage, the rest of the
+        // tail moves within the live elements, and the hole is
+        // assigned
+        std::uninitialized_move(array + count - n, array + count, array + count);
+        std::move_backward(array + index, array + count - n, array + count);
+        std::copy(first, last, array + index);
+      }
+      else
+      {
+        // the new elements past the old end and the whole tail land
+        // in raw storage, and the rest of the range is assigned over
+        // the moved-from tail
+        InputIt mid = std::next(first, tail);
+        std::uninitialized_copy(mid, last, array + count);
+        std::uninitialized_move(array + index, array + count, array + index + n);
+        std::copy(first, mid, array + index);
+      }
+      count += n;
     }
-    return false;
   }
 
-  // Sorts the elements in the sequence using less than equal (<=)
-  // operator. (Not implemented in HW-3)
+  // Extends the sequence by appending copies of the elements in
+  // [first, last).
+  template <typename T>
+  template <typename InputIt>
+  void ArraySeq<T>::append(InputIt first, InputIt last)
+  {
+    insert_range(count, first, last);
+  }
+
+  // Returns true if the element is in the sequence, and false
+  // otherwise.
+  template <typename T>
+  bool ArraySeq<T>::contains(const T& elem) const
+  {
+    return index_of(elem) >= 0;
+  }
+
+  // Returns the index of the first element equal to elem, or -1 if
+  // the element is not in the sequence.
+  template <typename T>
+  int ArraySeq<T>::index_of(const T& elem) const
+  {
+    return simd_find(array, count, elem);
+  }
+
+  // Grows the underlying array (if needed) so that it can hold at
+  // least n elements without reallocating.
+  template <typename T>
+  void ArraySeq<T>::reserve(int n)
+  {
+    if(n > cap)
+      reallocate(n);
+  }
+
+  // Shrinks the underlying array to exactly fit the current elements.
+  template <typename T>
+  void ArraySeq<T>::shrink_to_fit()
+  {
+    if(cap > count)
+      reallocate(count);
+  }
+
+  // Returns the number of elements the underlying array can hold
+  // before it must be reallocated.
+  template <typename T>
+  int ArraySeq<T>::capacity() const
+  {
+    return cap;
+  }
 
   // helper to double the capacity of the array
   template <typename T>
   void ArraySeq<T>::resize()
   {
-    if(capacity == 0)
-      capacity = 1;
+    if(cap == 0)
+      reallocate(1);
     
     else
-      capacity *= 2;
-    
-    T *new_array = new T[capacity];
-    for(int i = 0; i < capacity / 2; ++i)
-      new_array[i] = array[i];
-    
-    delete [] array;
+      reallocate(cap * 2);
+  }
+
+  // helper to grow the array (at least doubling it) so that it can
+  // hold n elements
+  template <typename T>
+  void ArraySeq<T>::grow_to(int n)
+  {
+    reallocate(std::max(n, cap * 2));
+  }
+
+  // helper to move the elements into a new array of the given
+  // capacity (which must be at least count)
+  template <typename T>
+  void ArraySeq<T>::reallocate(int new_cap)
+  {
+    T *new_array = nullptr;
+    if(new_cap > 0)
+      new_array = std::allocator<T>().allocate(new_cap);
+
+    if constexpr (is_bitwise_movable<T>::value)
+    {
+      if(count > 0)
+        std::memcpy(static_cast<void*>(new_array), array, count * sizeof(T));
+    }
+    else
+    {
+      std::uninitialized_move(array, array + count, new_array);
+      std::destroy(array, array + count);
+    }
+
+    if(array != nullptr)
+      std::allocator<T>().deallocate(array, cap);
     array = new_array;
+    cap = new_cap;
   }
   
-  // helper to delete the array list (called by destructor and copy
-  // constructor)
+  // helper to open a one element hole at the index by moving the
+  // elements after it one slot to the right
+  template <typename T>
+  void ArraySeq<T>::shift_right(int index)
+  {
+    if constexpr (is_bitwise_movable<T>::value)
+      std::memmove(static_cast<void*>(array + index + 1), array + index,
+                   (count - index) * sizeof(T));
+    else
+    {
+      new (array + count) T(std::move(array[count - 1]));
+      std::move_backward(array + index, array + count - 1, array + count);
+    }
+  }
+
+  // helper to close the hole at the index by moving the elements
+  // after it one slot to the left
+  template <typename T>
+  void ArraySeq<T>::shift_left(int index)
+  {
+    if constexpr (is_bitwise_movable<T>::value)
+      std::memmove(static_cast<void*>(array + index), array + index + 1,
+                   (count - index - 1) * sizeof(T));
+    else
+      std::move(array + index + 1, array + count, array + index);
+  }
+
+  // helper to destroy the elements and free the array (called by
+  // destructor and copy assignment)
   template <typename T>
   void ArraySeq<T>::make_empty()
   {
+    std::destroy(array, array + count);
+    if(array != nullptr)
+      std::allocator<T>().deallocate(array, cap);
+    array = nullptr;
     count = 0;
-    capacity = 0;
+    cap = 0;
   }
 
   template <typename T>
@@ -285,21 +729,58 @@ template <typename T>
     for (int i = 0; i < array.size(); i++)
     {
         if (i != array.size() - 1)
-            stream << array[i] << ", ";
+            stream << array.at_unchecked(i) << ", ";
         else 
         {
-            stream << array[i];
+            stream << array.at_unchecked(i);
         }
     }
     return stream;
 }
 
-// TODO: Implement the above functions below using the approaches
-//       discussed in class and specified in the homework assignment.
+// Sorts with radix sort when the elements support it and there are
+// enough of them, and with intro sort otherwise
+template <typename T>
+void ArraySeq<T>::sort()
+{
+  if constexpr (radix_traits<T>::sortable)
+  {
+    if(count >= radix_cutoff)
+    {
+      radix_sort();
+      return;
+    }
+  }
+
+  // depth limit of 2 * floor(log2(n))
+  int depth_limit = 0;
+  for(int n = count; n > 1; n /= 2)
+    depth_limit += 2;
+  intro_sort(0, count - 1, depth_limit);
+}
+
+// Sorts with a single scratch buffer of count elements, allocated
+// once for the whole sort
 template <typename T>
 void ArraySeq<T>::merge_sort()
 {
-  merge_sort(0,count -1);
+  if(count < 2)
+    return;
+  T* scratch = std::allocator<T>().allocate(count);
+  merge_sort(0, count - 1, scratch);
+  std::allocator<T>().deallocate(scratch, count);
+}
+
+template <typename T>
+void ArraySeq<T>::parallel_merge_sort(int threads)
+{
+  if(threads <= 0)
+    threads = std::max(1, (int) std::thread::hardware_concurrency());
+  if(count < 2)
+    return;
+  T* scratch = std::allocator<T>().allocate(count);
+  parallel_merge_sort(0, count - 1, scratch, threads);
+  std::allocator<T>().deallocate(scratch, count);
 }
 
 template <typename T>
@@ -309,66 +790,437 @@ void ArraySeq<T>::quick_sort()
 }
 
 template <typename T>
-void ArraySeq<T>::merge_sort(int start, int end)
+void ArraySeq<T>::heap_sort()
 {
-  int mid = (start + end) / 2;
-  
-  if(start < end)
+  heap_sort(0, count - 1);
+}
+
+// Bottom-up merge sort of [start, end]. Runs of insertion_cutoff
+// elements are insertion sorted in place, then merged pairwise back
+// and forth between the array and the matching slots of the scratch
+// buffer (raw storage, left raw again on return). The first pass is
+// chosen so the last pass lands in the array.
+template <typename T>
+void ArraySeq<T>::merge_sort(int start, int end, T* scratch)
+{
+  int n = end - start + 1;
+  for(int i = start; i <= end; i += insertion_cutoff)
+    insertion_sort(i, std::min(i + insertion_cutoff - 1, end));
+  if(n <= insertion_cutoff)
+    return;
+
+  int passes = 0;
+  for(long width = insertion_cutoff; width < n; width *= 2)
+    ++passes;
+
+  T* data = array + start;
+  T* buffer = scratch + start;
+  long width = insertion_cutoff;
+  if(passes % 2 == 0)
   {
-    merge_sort(start,mid);
-    merge_sort(mid+1,end);
+    merge_pass<true>(data, buffer, n, width);
+    width *= 2;
   }
-
   else
+    std::uninitialized_move(data, data + n, buffer);
+
+  T* src = buffer;
+  T* dst = data;
+  for(; width < n; width *= 2)
+  {
+    merge_pass<false>(src, dst, n, width);
+    std::swap(src, dst);
+  }
+  std::destroy(buffer, buffer + n);
+}
+
+// helper to merge each pair of adjacent sorted runs of the given width
+// from src into dst (stable, ties keep the left run first). When
+// Construct is true dst is raw storage and is move constructed,
+// otherwise it is move assigned.
+template <typename T>
+template <bool Construct>
+void ArraySeq<T>::merge_pass(T* src, T* dst, int n, long width)
+{
+  for(long lo = 0; lo < n; lo += 2 * width)
+  {
+    long mid = std::min(lo + width, (long) n);
+    long hi = std::min(lo + 2 * width, (long) n);
+    merge_runs<Construct>(src + lo, src + mid, src + mid, src + hi, dst + lo);
+  }
+}
+
+// helper to stably merge [first1, last1) and [first2, last2) into dst
+// (ties keep the first run first). When Construct is true dst is raw
+// storage and is move constructed, otherwise it is move assigned.
+template <typename T>
+template <bool Construct>
+void ArraySeq<T>::merge_runs(T* first1, T* last1, T* first2, T* last2, T* dst)
+{
+  auto put = [](T* slot, T& value)
+  {
+    if constexpr (Construct)
+      new (slot) T(std::move(value));
+    else
+      *slot = std::move(value);
+  };
+
+  while(first1 != last1 && first2 != last2)
+  {
+    if(*first2 < *first1)
+      put(dst++, *first2++);
+    else
+      put(dst++, *first1++);
+  }
+  while(first1 != last1)
+    put(dst++, *first1++);
+  while(first2 != last2)
+    put(dst++, *first2++);
+}
+
+// Sorts the two halves of [start, end] in parallel (splitting the
+// threads between them) until one thread is left or the range is
+// small, then merges the halves with all of the range's threads.
+template <typename T>
+void ArraySeq<T>::parallel_merge_sort(int start, int end, T* scratch, int threads)
+{
+  int n = end - start + 1;
+  if(threads <= 1 or n <= parallel_cutoff)
   {
+    merge_sort(start, end, scratch);
     return;
   }
 
-  T temp[(end-start) + 1];
-  int first1 = start;
-  int first2 = mid+1;
-  int i = 0;
-  while(first1 <= mid && first2 <= end)
+  int mid = start + n / 2;
+  int left_threads = threads / 2;
+  std::thread left([=]() {
+    parallel_merge_sort(start, mid - 1, scratch, left_threads);
+  });
+  parallel_merge_sort(mid, end, scratch, threads - left_threads);
+  left.join();
+  parallel_merge(start, mid, end, scratch, threads);
+}
+
+// Merges the sorted runs [start, mid) and [mid, end]. The output is
+// cut into one equal slice per thread, and co_rank finds where each
+// slice starts in both runs, so every thread merges its slice into
+// the scratch buffer independently. Once all slices are merged each
+// thread moves its slice back into the array.
+template <typename T>
+void ArraySeq<T>::parallel_merge(int start, int mid, int end, T* scratch, int threads)
+{
+  int n = end - start + 1;
+  T* a = array + start;
+  T* b = array + mid;
+  int na = mid - start;
+  int nb = end - mid + 1;
+
+  std::vector<int> out(threads + 1);
+  std::vector<int> from_a(threads + 1);
+  for(int p = 0; p <= threads; ++p)
+  {
+    out[p] = (int) ((long) n * p / threads);
+    from_a[p] = co_rank(out[p], a, na, b, nb);
+  }
+
+  auto merge_slice = [&](int p) {
+    int i1 = from_a[p], i2 = from_a[p + 1];
+    int j1 = out[p] - i1, j2 = out[p + 1] - i2;
+    merge_runs<true>(a + i1, a + i2, b + j1, b + j2, scratch + start + out[p]);
+  };
+  auto move_back = [&](int p) {
+    T* first = scratch + start + out[p];
+    T* last = scratch + start + out[p + 1];
+    std::move(first, last, array + start + out[p]);
+    std::destroy(first, last);
+  };
+
+  for(auto phase : {std::function<void(int)>(merge_slice),
+                    std::function<void(int)>(move_back)})
   {
-    if(array[first1] < array[first2])
-      temp[i++] = array[first1++];
+    std::vector<std::thread> workers;
+    for(int p = 1; p < threads; ++p)
+      workers.emplace_back(phase, p);
+    phase(0);
+    for(std::thread& worker : workers)
+      worker.join();
+  }
+}
 
+// helper to return how many of the first k merged elements of the
+// sorted runs a (na elements) and b (nb elements) come from a, with
+// ties taken from a first (matching merge_runs)
+template <typename T>
+int ArraySeq<T>::co_rank(int k, const T* a, int na, const T* b, int nb)
+{
+  int lo = std::max(0, k - nb);
+  int hi = std::min(k, na);
+  while(lo < hi)
+  {
+    int i = lo + (hi - lo) / 2;
+    int j = k - i;
+    // a[i] still belongs before b[j - 1], so more of a is needed
+    if(j > 0 and !(b[j - 1] < a[i]))
+      lo = i + 1;
     else
-      temp[i++] = array[first2++];
+      hi = i;
   }
-  while(first1 <= mid)
-    temp[i++] = array[first1++];
-  
-  while(first2 <= end)
-    temp[i++] = array[first2++];
-  
-  for(i = 0; i <= ( end - start); ++i)
-    array[start + i] = temp[i];
+  return lo;
 }
 
+  // Recurses into the smaller side and loops on the larger one, so
+  // the stack depth stays O(log n) even on bad inputs.
   template <typename T>
   void ArraySeq<T>::quick_sort(int start, int end)
   {
-    if (start < end)
+    while (start < end)
     {
-      T pivot = array[start];
-      int end_pos = start;
-      for(int i = start + 1; i <= end; ++i)
+      int end_pos = partition(start, end);
+      if (end_pos - start < end - end_pos)
       {
-        if(array[i] < pivot)
+        quick_sort(start, end_pos - 1);
+        start = end_pos + 1;
+      }
+      else
+      {
+        quick_sort(end_pos + 1, end);
+        end = end_pos - 1;
+      }
+    }
+  }
+
+  template <typename T>
+  void ArraySeq<T>::intro_sort(int start, int end, int depth_limit)
+  {
+    while (end - start + 1 > insertion_cutoff)
+    {
+      if (depth_limit == 0)
+      {
+        heap_sort(start, end);
+        return;
+      }
+      --depth_limit;
+      int end_pos = partition(start, end);
+      if (end_pos - start < end - end_pos)
+      {
+        intro_sort(start, end_pos - 1, depth_limit);
+        start = end_pos + 1;
+      }
+      else
+      {
+        intro_sort(end_pos + 1, end, depth_limit);
+        end = end_pos - 1;
+      }
+    }
+    insertion_sort(start, end);
+  }
+
+  template <typename T>
+  void ArraySeq<T>::insertion_sort(int start, int end)
+  {
+    for (int i = start + 1; i <= end; ++i)
+    {
+      T value = std::move(array[i]);
+      int j = i - 1;
+      while (j >= start && value < array[j])
+      {
+        array[j + 1] = std::move(array[j]);
+        --j;
+      }
+      array[j + 1] = std::move(value);
+    }
+  }
+
+  template <typename T>
+  void ArraySeq<T>::heap_sort(int start, int end)
+  {
+    int n = end - start + 1;
+    for (int root = n / 2 - 1; root >= 0; --root)
+      sift_down(start, root, n);
+    for (int last = n - 1; last > 0; --last)
+    {
+      std::swap(array[start], array[start + last]);
+      sift_down(start, 0, last);
+    }
+  }
+
+  // helper to restore the max-heap property below root for the heap
+  // of n elements stored at start
+  template <typename T>
+  void ArraySeq<T>::sift_down(int start, int root, int n)
+  {
+    T* heap = array + start;
+    T value = std::move(heap[root]);
+    int child = 2 * root + 1;
+    while (child < n)
+    {
+      if (child + 1 < n && heap[child] < heap[child + 1])
+        ++child;
+      if (!(value < heap[child]))
+        break;
+      heap[root] = std::move(heap[child]);
+      root = child;
+      child = 2 * root + 1;
+    }
+    heap[root] = std::move(value);
+  }
+
+  template <typename T>
+  int ArraySeq<T>::partition(int start, int end)
+  {
+    int mid = start + (end - start) / 2;
+    int pivot_index;
+    if (end - start + 1 > 128)
+    {
+      int step = (end - start + 1) / 8;
+      pivot_index = median_of_three(
+        median_of_three(start, start + step, start + 2 * step),
+        median_of_three(mid - step, mid, mid + step),
+        median_of_three(end - 2 * step, end - step, end));
+    }
+    else
+      pivot_index = median_of_three(start, mid, end);
+    std::swap(array[start], array[pivot_index]);
+
+    // Hoare style partition, both scans stop on keys equal to the
+    // pivot so runs of duplicates are split evenly
+    const T& pivot = array[start];
+    int i = start;
+    int j = end + 1;
+    while (true)
+    {
+      while (array[++i] < pivot)
+        if (i == end)
+          break;
+      while (pivot < array[--j])
+        if (j == start)
+          break;
+      if (i >= j)
+        break;
+      std::swap(array[i], array[j]);
+    }
+    std::swap(array[start], array[j]);
+    return j;
+  }
+
+  // Sorts by the radix_traits key one byte at a time, least
+  // significant first. Keys are mapped to unsigned values with the
+  // sign bit flipped, so negative keys sort first. One counting pass
+  // builds every digit's histogram, and digits where all keys share a
+  // bucket are skipped. The passes ping-pong between the array and a
+  // scratch buffer. Pairs with equal keys are then ordered by their
+  // second member.
+  template <typename T>
+  void ArraySeq<T>::radix_sort()
+  {
+    using traits = radix_traits<T>;
+    using K = typename traits::key_type;
+    using U = typename std::make_unsigned<K>::type;
+    const int digits = sizeof(K);
+    const U flip = std::is_signed<K>::value ? U(U(1) << (8 * sizeof(K) - 1)) : U(0);
+
+    std::vector<int> histogram(digits * 256, 0);
+    for(int i = 0; i < count; ++i)
+    {
+      U key = U(traits::key(array[i])) ^ flip;
+      for(int d = 0; d < digits; ++d)
+        ++histogram[d * 256 + ((key >> (8 * d)) & 0xFF)];
+    }
+
+    T* scratch = std::allocator<T>().allocate(count);
+    bool scratch_live = false;
+    T* src = array;
+    T* dst = scratch;
+    for(int d = 0; d < digits; ++d)
+    {
+      int* buckets = histogram.data() + d * 256;
+      if(*std::max_element(buckets, buckets + 256) == count)
+        continue;
+
+      // turn the counts into starting offsets
+      int offset = 0;
+      for(int b = 0; b < 256; ++b)
+      {
+        int n = buckets[b];
+        buckets[b] = offset;
+        offset += n;
+      }
+
+      // the first pass fills the raw scratch buffer
+      if(!scratch_live)
+      {
+        radix_scatter<true>(src, dst, count, 8 * d, buckets);
+        scratch_live = true;
+      }
+      else
+        radix_scatter<false>(src, dst, count, 8 * d, buckets);
+      std::swap(src, dst);
+    }
+
+    if(src == scratch)
+      std::move(scratch, scratch + count, array);
+    if(scratch_live)
+      std::destroy(scratch, scratch + count);
+    std::allocator<T>().deallocate(scratch, count);
+
+    if constexpr (traits::pair)
+    {
+      // order runs of equal keys by the rest of the pair
+      int start = 0;
+      for(int i = 1; i <= count; ++i)
+      {
+        if(i == count or traits::key(array[i]) != traits::key(array[start]))
         {
-          end_pos++;
-          T temp = array[i];
-          array[i] = array[end_pos];
-          array[end_pos] = temp;
+          int depth_limit = 0;
+          for(int n = i - start; n > 1; n /= 2)
+            depth_limit += 2;
+          if(i - start > 1)
+            intro_sort(start, i - 1, depth_limit);
+          start = i;
         }
       }
-      T temp = array[start];
-      array[start] = array[end_pos];
-      array[end_pos] = temp;
-      quick_sort(start, end_pos -1);
-      quick_sort(end_pos + 1, end);
     }
   }
 
+  // helper to scatter the n elements of src into dst by the digit at
+  // the given shift (stable). When Construct is true dst is raw
+  // storage and is move constructed, otherwise it is move assigned.
+  template <typename T>
+  template <bool Construct>
+  void ArraySeq<T>::radix_scatter(T* src, T* dst, int n, int shift, int* offsets)
+  {
+    using traits = radix_traits<T>;
+    using U = typename std::make_unsigned<typename traits::key_type>::type;
+    const U flip = std::is_signed<typename traits::key_type>::value ?
+      U(U(1) << (8 * sizeof(U) - 1)) : U(0);
+
+    for(int i = 0; i < n; ++i)
+    {
+      U key = U(traits::key(src[i])) ^ flip;
+      T* slot = dst + offsets[(key >> shift) & 0xFF]++;
+      if constexpr (Construct)
+        new (slot) T(std::move(src[i]));
+      else
+        *slot = std::move(src[i]);
+    }
+  }
+
+  template <typename T>
+  int ArraySeq<T>::median_of_three(int a, int b, int c) const
+  {
+    if (array[a] < array[b])
+    {
+      if (array[b] < array[c])
+        return b;
+      return array[a] < array[c] ? c : a;
+    }
+    if (array[a] < array[c])
+      return a;
+    return array[b] < array[c] ? c : b;
+  }
+
+static_assert(is_sequence<ArraySeq<int>, int>::value and
+              has_static_dispatch<ArraySeq<int>>::value,
+              "ArraySeq must satisfy the Sequence interface statically");
+
 #endif
\ No newline at end of file
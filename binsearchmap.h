@@ -7,11 +7,26 @@
 #ifndef BINSEARCHMAP_H
 #define BINSEARCHMAP_H
 
+#include <algorithm>
+#include <type_traits>
+#include <utility>
 #include "map.h"
+#include "interface.h"
+#include "keyview.h"
 #include "arrayseq.h"
+#include "pairlayout.h"
 
-template <typename K, typename V>
-class BinSearchMap : public Map<K, V>
+// Seq is the random access sequence holding the sorted pairs:
+// ArraySeq, TieredSeq (O(sqrt n) inserts and erases), GapSeq (cheap
+// runs of nearby edits), or RingSeq (cheap edits near either end).
+// Any other Seq must provide at_unchecked, emplace, and random access
+// iterators.
+// Layout is how the pairs are stored in Seq: PairLayout (one sequence
+// of pairs) or SplitLayout (a key sequence and a parallel value
+// sequence, so searches only touch keys).
+template <typename K, typename V, template <typename> class Seq = ArraySeq,
+          template <typename, typename, template <typename> class> class Layout = PairLayout>
+class BinSearchMap final : public Map<K, V>
 {
 public:
     // Returns the number of key-value pairs in the map
@@ -33,6 +48,19 @@ public:
     // collection. Insert does not check if the key is present.
     void insert(const K &key, const V &value);
 
+    // Same as above, moving the key and value into the collection
+    // instead of copying them.
+    void insert(K &&key, V &&value);
+
+    // Adds the key with a value constructed in place from the
+    // arguments (forwarded to V's constructor) if the key is not
+    // already in the collection. Returns true if the pair was added,
+    // and false (without using the arguments) otherwise.
+    template <typename... Args>
+    bool try_emplace(const K &key, Args &&...args);
+    template <typename... Args>
+    bool try_emplace(K &&key, Args &&...args);
+
     // Shrinks the collection by removing the key-value pair with the
     // given key. Does not modify the collection if the collection does
     // not contain the key. Throws out_of_range if the given key is not
@@ -49,16 +77,51 @@ public:
     // Returns the keys in the collection in ascending sorted order.
     ArraySeq<K> sorted_keys() const;
 
+    // Returns the values in the order of their keys, so the value for
+    // sorted_keys()[i] is sorted_values()[i] (a linear copy, with no
+    // key lookups).
+    ArraySeq<V> sorted_values() const;
+
+    // Same as find_keys and sorted_keys, but returns a view of the
+    // keys in place (O(log n), no allocation and no copying). A view
+    // is only valid until the map is next modified; use to_seq() on
+    // it to keep a copy. Only available when the keys are contiguous
+    // (Seq is ArraySeq).
+    KeyView<K> find_keys_view(const K &k1, const K &k2) const;
+    KeyView<K> sorted_keys_view() const;
+
 private:
+    // helper for both try_emplace overloads (KArg is const K& or K)
+    template <typename KArg, typename... Args>
+    bool emplace_unique(KArg &&key, Args &&...args);
+
     // If the key is in the collection, bin_search returns true and
     // provides the key's index within the array sequence (via the index
     // output parameter). If the key is not in the collection,
-    // bin_search returns false and provides the last index checked by
-    // the binary search algorithm.
+    // bin_search returns false and provides the index where the key
+    // would be inserted to keep the sequence sorted.
     bool bin_search(const K &key, int &index) const;
 
-    // implemented as a resizable array of (key-value) pairs
-    ArraySeq<std::pair<K, V>> seq;
+    // Returns the index of the first pair whose key is not less than
+    // the given key (size() if there is no such pair). Searches the
+    // sorted pairs in place without allocating.
+    int lower_bound(const K &key) const;
+
+    // Returns the index of the first pair whose key is greater than
+    // the given key (size() if there is no such pair).
+    int upper_bound(const K &key) const;
+
+    // Returns the first index whose key is not before the given key,
+    // where keys equal to the given key count as "before" when
+    // inclusive is true (shared by lower_bound and upper_bound).
+    int partition_point(const K &key, bool inclusive) const;
+
+    // true if the keys are stored contiguously (so they can be viewed
+    // in place)
+    static constexpr bool contiguous = Layout<K, V, Seq>::contiguous;
+
+    // implemented as resizable array(s) of keys and values
+    Layout<K, V, Seq> seq;
 };
 
 // TODO: Implement the BinSearchMap functions below. Note that you do
@@ -67,32 +130,34 @@ private:
 //       move assignment operator for this version of Map. Instead,
 //       the default C++ implementations are sufficient.
 
-#endif
 
 // Def
 
 // Returns the number of key-value pairs in the map
-template <typename K, typename V>
-int BinSearchMap<K, V>::size() const
+template <typename K, typename V, template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+int BinSearchMap<K, V, Seq, Layout>::size() const
 {
     return seq.size();
 }
 
 // Tests if the map is empty
-template <typename K, typename V>
-bool BinSearchMap<K, V>::empty() const
+template <typename K, typename V, template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+bool BinSearchMap<K, V, Seq, Layout>::empty() const
 {
     return seq.empty();
 }
 
 // Allows values associated with a key to be updated. Throws
 // out_of_range if the given key is not in the collection.
-template <typename K, typename V>
-V &BinSearchMap<K, V>::operator[](const K &key)
+template <typename K, typename V, template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+V &BinSearchMap<K, V, Seq, Layout>::operator[](const K &key)
 {
     int index = 0;
     if (bin_search(key, index))
-        return seq[index].second;
+        return seq.value(index);
     else
     {
         throw std::out_of_range("Out of range in the [] nonconst");
@@ -101,12 +166,13 @@ V &BinSearchMap<K, V>::operator[](const K &key)
 
 // Returns the value for a given key. Throws out_of_range if the
 // given key is not in the collection.
-template <typename K, typename V>
-const V &BinSearchMap<K, V>::operator[](const K &key) const
+template <typename K, typename V, template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+const V &BinSearchMap<K, V, Seq, Layout>::operator[](const K &key) const
 {
     int index = 0;
     if (bin_search(key, index))
-      return seq[index].second;
+      return seq.value(index);
     else
     {
         throw std::out_of_range("Out of range in the [] nonconst");
@@ -116,20 +182,65 @@ const V &BinSearchMap<K, V>::operator[](const K &key) const
 // Extends the collection by adding the given key-value
 // pair. Assumes the key being added is not present in the
 // collection. Insert does not check if the key is present.
-template <typename K, typename V>
-void BinSearchMap<K, V>::insert(const K &key, const V &value)
+template <typename K, typename V, template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+void BinSearchMap<K, V, Seq, Layout>::insert(const K &key, const V &value)
+{
+    int index = 0;
+    if (!bin_search(key, index))
+      seq.emplace(index, key, value);
+}
+
+// Extends the collection by moving the given key-value pair in.
+// Assumes the key being added is not present in the collection.
+template <typename K, typename V, template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+void BinSearchMap<K, V, Seq, Layout>::insert(K &&key, V &&value)
 {
     int index = 0;
     if (!bin_search(key, index))
-      seq.insert({key, value}, index);
+      seq.emplace(index, std::move(key), std::move(value));
+}
+
+// Adds the key with a value constructed in place from the arguments
+// if the key is not already in the collection.
+template <typename K, typename V, template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+template <typename... Args>
+bool BinSearchMap<K, V, Seq, Layout>::try_emplace(const K &key, Args &&...args)
+{
+    return emplace_unique(key, std::forward<Args>(args)...);
+}
+
+template <typename K, typename V, template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+template <typename... Args>
+bool BinSearchMap<K, V, Seq, Layout>::try_emplace(K &&key, Args &&...args)
+{
+    return emplace_unique(std::move(key), std::forward<Args>(args)...);
+}
+
+// Returns false if the key is in the collection, otherwise adds the
+// key (forwarded) with a value constructed from the arguments.
+template <typename K, typename V, template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+template <typename KArg, typename... Args>
+bool BinSearchMap<K, V, Seq, Layout>::emplace_unique(KArg &&key, Args &&...args)
+{
+    int index = 0;
+    if (bin_search(key, index))
+        return false;
+    seq.emplace(index, std::forward<KArg>(key), std::forward<Args>(args)...);
+    return true;
 }
 
 // Shrinks the collection by removing the key-value pair with the
 // given key. Does not modify the collection if the collection does
 // not contain the key. Throws out_of_range if the given key is not
 // in the collection.
-template <typename K, typename V>
-void BinSearchMap<K, V>::erase(const K &key)
+template <typename K, typename V, template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+void BinSearchMap<K, V, Seq, Layout>::erase(const K &key)
 {
     int index = 0;
     if (bin_search(key, index))
@@ -143,75 +254,148 @@ void BinSearchMap<K, V>::erase(const K &key)
 
 // Returns true if the key is in the collection, and false
 // otherwise.
-template <typename K, typename V>
-bool BinSearchMap<K, V>::contains(const K &key) const
+template <typename K, typename V, template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+bool BinSearchMap<K, V, Seq, Layout>::contains(const K &key) const
 {
-    for (int i = 0; i < seq.size(); ++i)
-    {
-        if (seq[i].first == key)
-          return true;
-    }
-    return false;
+    int index = 0;
+    return bin_search(key, index);
 }
 
 // Returns the keys k in the collection such that k1 <= k <= k2
-template <typename K, typename V>
-ArraySeq<K> BinSearchMap<K, V>::find_keys(const K &k1, const K &k2) const
+template <typename K, typename V, template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+ArraySeq<K> BinSearchMap<K, V, Seq, Layout>::find_keys(const K &k1, const K &k2) const
 {
-    ArraySeq<K> new_seq;
-    ArraySeq<K> keys = sorted_keys();
-    for (int i = 0; i < keys.size(); ++i)
-    {
-        if (keys[i] >= k1 && keys[i] <= k2)
-          new_seq.insert(keys[i], new_seq.size());
-    }
-    return new_seq;
+    int start = lower_bound(k1);
+    int end = std::max(start, upper_bound(k2));
+    return seq.copy_keys(start, end);
 }
 
 // Returns the keys in the collection in ascending sorted order.
-template <typename K, typename V>
-ArraySeq<K> BinSearchMap<K, V>::sorted_keys() const
+template <typename K, typename V, template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+ArraySeq<K> BinSearchMap<K, V, Seq, Layout>::sorted_keys() const
+{
+    return seq.copy_keys(0, seq.size());
+}
+
+// Returns the values in the order of their keys.
+template <typename K, typename V, template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+ArraySeq<V> BinSearchMap<K, V, Seq, Layout>::sorted_values() const
 {
-    ArraySeq<K> new_seq;
+    ArraySeq<V> values;
+    values.reserve(seq.size());
     for (int i = 0; i < seq.size(); ++i)
-        new_seq.insert(seq[i].first, new_seq.size());
+        values.insert(seq.value(i), i);
+    return values;
+}
+
+// Returns a view of the keys k in the collection such that
+// k1 <= k <= k2
+template <typename K, typename V, template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+KeyView<K> BinSearchMap<K, V, Seq, Layout>::find_keys_view(const K &k1, const K &k2) const
+{
+    static_assert(contiguous, "key views need contiguous (ArraySeq) storage");
+    int start = lower_bound(k1);
+    int end = std::max(start, upper_bound(k2));
+    if (start == end)
+        return KeyView<K>();
+    return seq.key_view(start, end);
+}
 
-    return new_seq;
+// Returns a view of the keys in the collection in ascending sorted
+// order.
+template <typename K, typename V, template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+KeyView<K> BinSearchMap<K, V, Seq, Layout>::sorted_keys_view() const
+{
+    static_assert(contiguous, "key views need contiguous (ArraySeq) storage");
+    if (seq.empty())
+        return KeyView<K>();
+    return seq.key_view(0, seq.size());
 }
 
 // If the key is in the collection, bin_search returns true and
 // provides the key's index within the array sequence (via the index
 // output parameter). If the key is not in the collection,
-// bin_search returns false and provides the last index checked by
-// the binary search algorithm.
-template <typename K, typename V>
-bool BinSearchMap<K, V>::bin_search(const K &key, int &index) const
+// bin_search returns false and provides the index where the key
+// would be inserted to keep the sequence sorted.
+template <typename K, typename V, template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+bool BinSearchMap<K, V, Seq, Layout>::bin_search(const K &key, int &index) const
 {
-    if (seq.size() == 0)
-        return false;
+    index = lower_bound(key);
+    return index < seq.size() && !(key < seq.key(index));
+}
 
-    ArraySeq<K> new_seq = sorted_keys();
-    int start = 0;
-    int end = new_seq.size() - 1;
-    while (start <= end)
+// Returns the index of the first pair whose key is not less than the
+// given key (size() if there is no such pair).
+template <typename K, typename V, template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+int BinSearchMap<K, V, Seq, Layout>::lower_bound(const K &key) const
+{
+    return partition_point(key, false);
+}
+
+// Returns the index of the first pair whose key is greater than the
+// given key (size() if there is no such pair).
+template <typename K, typename V, template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+int BinSearchMap<K, V, Seq, Layout>::upper_bound(const K &key) const
+{
+    return partition_point(key, true);
+}
+
+// Returns the first index whose key is not before the given key, where
+// keys equal to the given key count as "before" when inclusive is
+// true. For arithmetic keys the halving step is a conditional move
+// instead of a branch, so the loop runs a fixed log2(n) iterations
+// regardless of the key.
+template <typename K, typename V, template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+int BinSearchMap<K, V, Seq, Layout>::partition_point(const K &key, bool inclusive) const
+{
+    auto before = [&key, inclusive](const K &k)
+    {
+        return inclusive ? !(key < k) : k < key;
+    };
+
+    int n = seq.size();
+    if (n == 0)
+        return 0;
+
+    if constexpr (std::is_arithmetic<K>::value)
     {
-        index = (start + end) / 2;                      
-        if (start == end)
+        int base = 0;
+        while (n > 1)
         {
-            if (new_seq[index] == key)
-                return true;
-            index = start;
-            return false;
+            int half = n / 2;
+            base = before(seq.key(base + half)) ? base + half : base;
+            n -= half;
         }
+        return base + before(seq.key(base));
+    }
+    else
+    {
+        int start = 0;
+        int end = n;
+        while (start < end)
+        {
+            int mid = start + (end - start) / 2;
+            if (before(seq.key(mid)))
+                start = mid + 1;
+            else
+                end = mid;
+        }
+        return start;
+    }
+}
 
-        if (new_seq[index] == key)
-          return true;
-        
-        if (new_seq[index] < key)
-            start = index + 1;
+static_assert(is_map<BinSearchMap<int, int>, int, int>::value and
+              has_static_dispatch<BinSearchMap<int, int>>::value,
+              "BinSearchMap must satisfy the Map interface statically");
 
-        if (new_seq[index] > key) 
-            end = index-1;
-    }
-    return false;
-}
\ No newline at end of file
+#endif
@@ -0,0 +1,898 @@
+//---------------------------------------------------------------------------
+// NAME: Mason Manca
+// FILE: btreemap.h
+// DATE: Fall 2021
+// DESC: B+tree implementation of Map. Every key-value pair lives in a
+//       leaf, and leaves are chained in key order, so ordered key
+//       queries are a scan along the chain. Inner nodes hold only
+//       separator keys and child pointers. A node holds up to NodeCap
+//       keys in one array (64 by default, four cache lines of int
+//       keys), searched with a linear counting loop for arithmetic
+//       keys (which the compiler vectorizes) and a binary search
+//       otherwise. Full nodes split on insert; nodes less than half
+//       full after an erase borrow from or merge with a sibling, so
+//       insert, erase, and lookup are O(log n). Nodes come from
+//       NodePools (see nodepool.h). A map can also be bulk loaded
+//       from sorted keys and values in O(n).
+//---------------------------------------------------------------------------
+
+#ifndef BTREEMAP_H
+#define BTREEMAP_H
+
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "map.h"
+#include "interface.h"
+#include "arrayseq.h"
+#include "nodepool.h"
+
+template <typename K, typename V, int NodeCap = 64>
+class BTreeMap final : public Map<K, V>
+{
+    static_assert(NodeCap >= 4, "BTreeMap nodes must hold at least 4 keys");
+
+public:
+    // Default constructor
+    BTreeMap();
+
+    // Builds the map from keys in ascending order (without
+    // duplicates) and their values at the same indexes, filling the
+    // nodes bottom up. Throws out_of_range if the two sequences differ
+    // in length.
+    BTreeMap(ArraySeq<K> sorted_keys, ArraySeq<V> sorted_values);
+
+    // Copy constructor
+    BTreeMap(const BTreeMap &rhs);
+
+    // Move constructor
+    BTreeMap(BTreeMap &&rhs);
+
+    // Copy assignment operator
+    BTreeMap &operator=(const BTreeMap &rhs);
+
+    // Move assignment operator
+    BTreeMap &operator=(BTreeMap &&rhs);
+
+    // Destructor
+    ~BTreeMap();
+
+    // Returns the number of key-value pairs in the map
+    int size() const;
+
+    // Tests if the map is empty
+    bool empty() const;
+
+    // Allows values associated with a key to be updated. Throws
+    // out_of_range if the given key is not in the collection.
+    V &operator[](const K &key);
+
+    // Returns the value for a given key. Throws out_of_range if the
+    // given key is not in the collection.
+    const V &operator[](const K &key) const;
+
+    // Extends the collection by adding the given key-value pair (if
+    // the key is not already present).
+    void insert(const K &key, const V &value);
+
+    // Same as above, moving the key and value into the collection
+    // instead of copying them.
+    void insert(K &&key, V &&value);
+
+    // Adds the key with a value constructed in place from the
+    // arguments (forwarded to V's constructor) if the key is not
+    // already in the collection. Returns true if the pair was added,
+    // and false (without using the arguments) otherwise.
+    template <typename... Args>
+    bool try_emplace(const K &key, Args &&...args);
+    template <typename... Args>
+    bool try_emplace(K &&key, Args &&...args);
+
+    // Shrinks the collection by removing the key-value pair with the
+    // given key. Throws out_of_range if the given key is not in the
+    // collection.
+    void erase(const K &key);
+
+    // Returns true if the key is in the collection, and false
+    // otherwise.
+    bool contains(const K &key) const;
+
+    // Returns the keys k in the collection such that k1 <= k <= k2
+    ArraySeq<K> find_keys(const K &k1, const K &k2) const;
+
+    // Returns the keys in the collection in ascending sorted order.
+    ArraySeq<K> sorted_keys() const;
+
+private:
+    // fewest keys in a node other than the root
+    static constexpr int min_keys = NodeCap / 2;
+
+    // deepest possible tree (every node but the root is at least half
+    // full, so each level at least doubles the number of keys)
+    static constexpr int max_height = 32;
+
+    // common part of leaves and inner nodes: the number of keys and
+    // the keys (only the first count are constructed)
+    struct Node
+    {
+        int count;
+        alignas(K) unsigned char key_storage[NodeCap * sizeof(K)];
+
+        K *keys() { return reinterpret_cast<K *>(key_storage); }
+    };
+
+    // leaf: keys with their values at the same indexes, and the next
+    // leaf in key order
+    struct Leaf : Node
+    {
+        Leaf *next;
+        alignas(V) unsigned char value_storage[NodeCap * sizeof(V)];
+
+        V *values() { return reinterpret_cast<V *>(value_storage); }
+    };
+
+    // inner node: count keys and count + 1 children. Child i holds the
+    // keys less than key i, and keys at least key i - 1.
+    struct Inner : Node
+    {
+        Node *children[NodeCap + 1];
+    };
+
+    // the root (a leaf when height is 0, null when the map is empty)
+    Node *root = nullptr;
+
+    // number of inner levels above the leaves
+    int height = 0;
+
+    // first leaf in key order
+    Leaf *first_leaf = nullptr;
+
+    // number of pairs
+    int count = 0;
+
+    // node storage
+    NodePool<Leaf> leaves;
+    NodePool<Inner> inners;
+
+    // path from the root to a leaf: the inner node at each depth and
+    // the index of the child taken from it
+    struct Path
+    {
+        Inner *nodes[max_height];
+        int slots[max_height];
+    };
+
+    // Returns how many of the n keys are before the key: less than it,
+    // or also equal to it when inclusive is true
+    static int rank(const K *keys, int n, const K &key, bool inclusive);
+
+    // helper to walk from the root to the leaf that holds (or would
+    // hold) the key, recording the path, and return the leaf
+    Leaf *descend(const K &key, Path *path) const;
+
+    // helper to return the leaf and index of the key, or null if the
+    // key is not present
+    Leaf *find(const K &key, int &index) const;
+
+    // helpers to allocate an empty node
+    Leaf *new_leaf();
+    Inner *new_inner();
+
+    // helper to move n constructed items from src into raw storage at
+    // dst, leaving src as raw storage
+    template <typename T>
+    static void relocate(T *src, int n, T *dst);
+
+    // helper to shift items [index, n) one to the right, leaving
+    // item index as raw storage
+    template <typename T>
+    static void open_gap(T *items, int n, int index);
+
+    // helper to shift items [index + 1, n) one to the left over the
+    // raw (already destroyed) item index
+    template <typename T>
+    static void close_gap(T *items, int n, int index);
+
+    // helper to add a key and the child to its right to an inner node
+    // that is not full
+    static void inner_insert(Inner *node, int index, K &&key, Node *right);
+
+    // helper to remove key index and child index + 1 of an inner node
+    static void inner_erase(Inner *node, int index);
+
+    // helper for insert and both try_emplace overloads (KArg is
+    // const K& or K)
+    template <typename KArg, typename... Args>
+    bool emplace_unique(KArg &&key, Args &&...args);
+
+    // helper to fix the underfull child index of the parent (a leaf
+    // when leaf is true) by borrowing a key from or merging with a
+    // sibling
+    void rebalance(Inner *parent, int index, bool leaf);
+
+    // helper to build the tree from sorted pairs (the map must be
+    // empty)
+    void bulk_load(ArraySeq<K> &sorted_keys, ArraySeq<V> &sorted_values);
+
+    // helper to destroy the keys below (and in) the node at the given
+    // height
+    void destroy(Node *node, int level);
+
+    // helper to destroy the pairs and release the nodes
+    void make_empty();
+};
+
+
+// Default constructor
+template <typename K, typename V, int NodeCap>
+BTreeMap<K, V, NodeCap>::BTreeMap()
+{
+}
+
+// Builds the map from sorted keys and their values
+template <typename K, typename V, int NodeCap>
+BTreeMap<K, V, NodeCap>::BTreeMap(ArraySeq<K> sorted_keys, ArraySeq<V> sorted_values)
+{
+    if (sorted_keys.size() != sorted_values.size())
+        throw std::out_of_range("Out of range in BTreeMap, key and value counts differ");
+    bulk_load(sorted_keys, sorted_values);
+}
+
+// Copy constructor
+template <typename K, typename V, int NodeCap>
+BTreeMap<K, V, NodeCap>::BTreeMap(const BTreeMap &rhs)
+{
+    *this = rhs;
+}
+
+// Move constructor
+template <typename K, typename V, int NodeCap>
+BTreeMap<K, V, NodeCap>::BTreeMap(BTreeMap &&rhs)
+{
+    *this = std::move(rhs);
+}
+
+// Copy assignment operator, bulk loading the pairs of rhs in order
+template <typename K, typename V, int NodeCap>
+BTreeMap<K, V, NodeCap> &BTreeMap<K, V, NodeCap>::operator=(const BTreeMap &rhs)
+{
+    if (this != &rhs)
+    {
+        make_empty();
+        ArraySeq<K> sorted_keys;
+        ArraySeq<V> sorted_values;
+        sorted_keys.reserve(rhs.count);
+        sorted_values.reserve(rhs.count);
+        for (Leaf *leaf = rhs.first_leaf; leaf != nullptr; leaf = leaf->next)
+        {
+            sorted_keys.append(leaf->keys(), leaf->keys() + leaf->count);
+            sorted_values.append(leaf->values(), leaf->values() + leaf->count);
+        }
+        bulk_load(sorted_keys, sorted_values);
+    }
+    return *this;
+}
+
+// Move assignment operator
+template <typename K, typename V, int NodeCap>
+BTreeMap<K, V, NodeCap> &BTreeMap<K, V, NodeCap>::operator=(BTreeMap &&rhs)
+{
+    if (this != &rhs)
+    {
+        make_empty();
+        root = rhs.root;
+        height = rhs.height;
+        first_leaf = rhs.first_leaf;
+        count = rhs.count;
+        leaves = std::move(rhs.leaves);
+        inners = std::move(rhs.inners);
+        rhs.root = nullptr;
+        rhs.first_leaf = nullptr;
+        rhs.height = rhs.count = 0;
+    }
+    return *this;
+}
+
+// Destructor
+template <typename K, typename V, int NodeCap>
+BTreeMap<K, V, NodeCap>::~BTreeMap()
+{
+    make_empty();
+}
+
+// Returns the number of key-value pairs in the map
+template <typename K, typename V, int NodeCap>
+int BTreeMap<K, V, NodeCap>::size() const
+{
+    return count;
+}
+
+// Tests if the map is empty
+template <typename K, typename V, int NodeCap>
+bool BTreeMap<K, V, NodeCap>::empty() const
+{
+    return count == 0;
+}
+
+// Allows values associated with a key to be updated. Throws
+// out_of_range if the given key is not in the collection.
+template <typename K, typename V, int NodeCap>
+V &BTreeMap<K, V, NodeCap>::operator[](const K &key)
+{
+    int index = 0;
+    Leaf *leaf = find(key, index);
+    if (leaf == nullptr)
+        throw std::out_of_range("Out of range in the [] nonconst");
+    return leaf->values()[index];
+}
+
+// Returns the value for a given key. Throws out_of_range if the
+// given key is not in the collection.
+template <typename K, typename V, int NodeCap>
+const V &BTreeMap<K, V, NodeCap>::operator[](const K &key) const
+{
+    int index = 0;
+    Leaf *leaf = find(key, index);
+    if (leaf == nullptr)
+        throw std::out_of_range("Out of range in the [] const");
+    return leaf->values()[index];
+}
+
+// Extends the collection by adding the given key-value pair
+template <typename K, typename V, int NodeCap>
+void BTreeMap<K, V, NodeCap>::insert(const K &key, const V &value)
+{
+    emplace_unique(key, value);
+}
+
+// Extends the collection by moving the given key-value pair in
+template <typename K, typename V, int NodeCap>
+void BTreeMap<K, V, NodeCap>::insert(K &&key, V &&value)
+{
+    emplace_unique(std::move(key), std::move(value));
+}
+
+// Adds the key with a value constructed in place from the arguments
+// if the key is not already in the collection.
+template <typename K, typename V, int NodeCap>
+template <typename... Args>
+bool BTreeMap<K, V, NodeCap>::try_emplace(const K &key, Args &&...args)
+{
+    return emplace_unique(key, std::forward<Args>(args)...);
+}
+
+template <typename K, typename V, int NodeCap>
+template <typename... Args>
+bool BTreeMap<K, V, NodeCap>::try_emplace(K &&key, Args &&...args)
+{
+    return emplace_unique(std::move(key), std::forward<Args>(args)...);
+}
+
+// Returns false if the key is in the collection, otherwise adds the
+// pair to its leaf. A full leaf is split in half first, and the first
+// key of the new right half is added to the parent, splitting full
+// inner nodes the same way up the path (the middle key of a split
+// inner node moves up). A split root gets a new root above it. The
+// key and value are built before anything moves, since the arguments
+// may refer into the map.
+template <typename K, typename V, int NodeCap>
+template <typename KArg, typename... Args>
+bool BTreeMap<K, V, NodeCap>::emplace_unique(KArg &&key, Args &&...args)
+{
+    Path path;
+    Leaf *leaf = root == nullptr ? nullptr : descend(key, &path);
+    int index = leaf == nullptr ? 0 : rank(leaf->keys(), leaf->count, key, false);
+    if (leaf != nullptr and index < leaf->count and !(key < leaf->keys()[index]))
+        return false;
+
+    K new_key(std::forward<KArg>(key));
+    V new_value(std::forward<Args>(args)...);
+    if (root == nullptr)
+    {
+        leaf = new_leaf();
+        root = first_leaf = leaf;
+    }
+
+    Node *right = nullptr;
+    if (leaf->count == NodeCap)
+    {
+        Leaf *split = new_leaf();
+        relocate(leaf->keys() + min_keys, NodeCap - min_keys, split->keys());
+        relocate(leaf->values() + min_keys, NodeCap - min_keys, split->values());
+        split->count = NodeCap - min_keys;
+        leaf->count = min_keys;
+        split->next = leaf->next;
+        leaf->next = split;
+        if (index > min_keys)
+        {
+            leaf = split;
+            index -= min_keys;
+        }
+        right = split;
+    }
+    open_gap(leaf->keys(), leaf->count, index);
+    open_gap(leaf->values(), leaf->count, index);
+    new (leaf->keys() + index) K(std::move(new_key));
+    new (leaf->values() + index) V(std::move(new_value));
+    ++leaf->count;
+    ++count;
+    if (right == nullptr)
+        return true;
+
+    K separator(right->keys()[0]);
+    for (int depth = height - 1; depth >= 0 and right != nullptr; --depth)
+    {
+        Inner *node = path.nodes[depth];
+        int slot = path.slots[depth];
+        if (node->count < NodeCap)
+        {
+            inner_insert(node, slot, std::move(separator), right);
+            right = nullptr;
+        }
+        else
+        {
+            Inner *split = new_inner();
+            K middle(std::move(node->keys()[min_keys]));
+            std::destroy_at(node->keys() + min_keys);
+            relocate(node->keys() + min_keys + 1, NodeCap - min_keys - 1, split->keys());
+            std::memcpy(split->children, node->children + min_keys + 1,
+                        (NodeCap - min_keys) * sizeof(Node *));
+            split->count = NodeCap - min_keys - 1;
+            node->count = min_keys;
+            if (slot <= min_keys)
+                inner_insert(node, slot, std::move(separator), right);
+            else
+                inner_insert(split, slot - min_keys - 1, std::move(separator), right);
+            separator = std::move(middle);
+            right = split;
+        }
+    }
+    if (right != nullptr)
+    {
+        Inner *new_root = new_inner();
+        new (new_root->keys()) K(std::move(separator));
+        new_root->children[0] = root;
+        new_root->children[1] = right;
+        new_root->count = 1;
+        root = new_root;
+        ++height;
+    }
+    return true;
+}
+
+// Removes the pair from its leaf, then rebalances each underfull node
+// on the path with a sibling, bottom up. A root left with one child is
+// replaced by the child. Separators of erased keys can stay in the
+// inner nodes, since they still divide the keys correctly.
+template <typename K, typename V, int NodeCap>
+void BTreeMap<K, V, NodeCap>::erase(const K &key)
+{
+    Path path;
+    Leaf *leaf = root == nullptr ? nullptr : descend(key, &path);
+    int index = leaf == nullptr ? 0 : rank(leaf->keys(), leaf->count, key, false);
+    if (leaf == nullptr or index == leaf->count or key < leaf->keys()[index])
+        throw std::out_of_range("Out of range in erase");
+
+    std::destroy_at(leaf->keys() + index);
+    std::destroy_at(leaf->values() + index);
+    close_gap(leaf->keys(), leaf->count, index);
+    close_gap(leaf->values(), leaf->count, index);
+    --leaf->count;
+    --count;
+
+    Node *node = leaf;
+    for (int depth = height - 1; depth >= 0 and node->count < min_keys; --depth)
+    {
+        rebalance(path.nodes[depth], path.slots[depth], depth == height - 1);
+        node = path.nodes[depth];
+    }
+    if (height > 0 and root->count == 0)
+    {
+        Inner *old_root = static_cast<Inner *>(root);
+        root = old_root->children[0];
+        inners.deallocate(old_root);
+        --height;
+    }
+    else if (count == 0)
+    {
+        leaves.deallocate(static_cast<Leaf *>(root));
+        root = nullptr;
+        first_leaf = nullptr;
+    }
+}
+
+// Returns true if the key is in the collection, and false
+// otherwise.
+template <typename K, typename V, int NodeCap>
+bool BTreeMap<K, V, NodeCap>::contains(const K &key) const
+{
+    int index = 0;
+    return find(key, index) != nullptr;
+}
+
+// Returns the keys k in the collection such that k1 <= k <= k2, by
+// scanning the leaf chain from the leaf that would hold k1
+template <typename K, typename V, int NodeCap>
+ArraySeq<K> BTreeMap<K, V, NodeCap>::find_keys(const K &k1, const K &k2) const
+{
+    ArraySeq<K> found;
+    if (root == nullptr or k2 < k1)
+        return found;
+    Leaf *leaf = descend(k1, nullptr);
+    int start = rank(leaf->keys(), leaf->count, k1, false);
+    for (; leaf != nullptr; leaf = leaf->next, start = 0)
+    {
+        int end = rank(leaf->keys(), leaf->count, k2, true);
+        found.append(leaf->keys() + start, leaf->keys() + end);
+        if (end < leaf->count)
+            break;
+    }
+    return found;
+}
+
+// Returns the keys in the collection in ascending sorted order, by
+// copying each leaf's keys along the chain
+template <typename K, typename V, int NodeCap>
+ArraySeq<K> BTreeMap<K, V, NodeCap>::sorted_keys() const
+{
+    ArraySeq<K> keys;
+    keys.reserve(count);
+    for (Leaf *leaf = first_leaf; leaf != nullptr; leaf = leaf->next)
+        keys.append(leaf->keys(), leaf->keys() + leaf->count);
+    return keys;
+}
+
+// Counts the keys before the given key. For arithmetic keys this is a
+// branch free loop over all n keys; otherwise a binary search.
+template <typename K, typename V, int NodeCap>
+int BTreeMap<K, V, NodeCap>::rank(const K *keys, int n, const K &key, bool inclusive)
+{
+    if constexpr (std::is_arithmetic<K>::value)
+    {
+        int before = 0;
+        if (inclusive)
+            for (int i = 0; i < n; ++i)
+                before += !(key < keys[i]);
+        else
+            for (int i = 0; i < n; ++i)
+                before += keys[i] < key;
+        return before;
+    }
+    else
+    {
+        int start = 0;
+        int end = n;
+        while (start < end)
+        {
+            int mid = start + (end - start) / 2;
+            if (inclusive ? !(key < keys[mid]) : keys[mid] < key)
+                start = mid + 1;
+            else
+                end = mid;
+        }
+        return start;
+    }
+}
+
+// Takes the child after the keys not greater than the key at each
+// inner node (the map must not be empty)
+template <typename K, typename V, int NodeCap>
+typename BTreeMap<K, V, NodeCap>::Leaf *
+BTreeMap<K, V, NodeCap>::descend(const K &key, Path *path) const
+{
+    Node *node = root;
+    for (int depth = 0; depth < height; ++depth)
+    {
+        Inner *inner = static_cast<Inner *>(node);
+        int slot = rank(inner->keys(), inner->count, key, true);
+        if (path != nullptr)
+        {
+            path->nodes[depth] = inner;
+            path->slots[depth] = slot;
+        }
+        node = inner->children[slot];
+    }
+    return static_cast<Leaf *>(node);
+}
+
+// Returns the key's leaf and its index there, or null if not present
+template <typename K, typename V, int NodeCap>
+typename BTreeMap<K, V, NodeCap>::Leaf *
+BTreeMap<K, V, NodeCap>::find(const K &key, int &index) const
+{
+    if (root == nullptr)
+        return nullptr;
+    Leaf *leaf = descend(key, nullptr);
+    index = rank(leaf->keys(), leaf->count, key, false);
+    if (index == leaf->count or key < leaf->keys()[index])
+        return nullptr;
+    return leaf;
+}
+
+// Allocates an empty leaf
+template <typename K, typename V, int NodeCap>
+typename BTreeMap<K, V, NodeCap>::Leaf *BTreeMap<K, V, NodeCap>::new_leaf()
+{
+    Leaf *leaf = new (leaves.allocate()) Leaf;
+    leaf->count = 0;
+    leaf->next = nullptr;
+    return leaf;
+}
+
+// Allocates an empty inner node
+template <typename K, typename V, int NodeCap>
+typename BTreeMap<K, V, NodeCap>::Inner *BTreeMap<K, V, NodeCap>::new_inner()
+{
+    Inner *inner = new (inners.allocate()) Inner;
+    inner->count = 0;
+    return inner;
+}
+
+// Moves n items from src into raw storage at dst (memcpy for bitwise
+// movable types)
+template <typename K, typename V, int NodeCap>
+template <typename T>
+void BTreeMap<K, V, NodeCap>::relocate(T *src, int n, T *dst)
+{
+    if constexpr (is_bitwise_movable<T>::value)
+        std::memcpy(static_cast<void *>(dst), src, n * sizeof(T));
+    else
+    {
+        std::uninitialized_move(src, src + n, dst);
+        std::destroy(src, src + n);
+    }
+}
+
+// Moves items [index, n) one to the right, from the back
+template <typename K, typename V, int NodeCap>
+template <typename T>
+void BTreeMap<K, V, NodeCap>::open_gap(T *items, int n, int index)
+{
+    if constexpr (is_bitwise_movable<T>::value)
+        std::memmove(static_cast<void *>(items + index + 1), items + index,
+                     (n - index) * sizeof(T));
+    else
+        for (int i = n; i > index; --i)
+        {
+            new (items + i) T(std::move(items[i - 1]));
+            std::destroy_at(items + i - 1);
+        }
+}
+
+// Moves items [index + 1, n) one to the left, from the front
+template <typename K, typename V, int NodeCap>
+template <typename T>
+void BTreeMap<K, V, NodeCap>::close_gap(T *items, int n, int index)
+{
+    if constexpr (is_bitwise_movable<T>::value)
+        std::memmove(static_cast<void *>(items + index), items + index + 1,
+                     (n - index - 1) * sizeof(T));
+    else
+        for (int i = index; i < n - 1; ++i)
+        {
+            new (items + i) T(std::move(items[i + 1]));
+            std::destroy_at(items + i + 1);
+        }
+}
+
+// Adds key index and child index + 1 to the inner node
+template <typename K, typename V, int NodeCap>
+void BTreeMap<K, V, NodeCap>::inner_insert(Inner *node, int index, K &&key, Node *right)
+{
+    open_gap(node->keys(), node->count, index);
+    new (node->keys() + index) K(std::move(key));
+    std::memmove(node->children + index + 2, node->children + index + 1,
+                 (node->count - index) * sizeof(Node *));
+    node->children[index + 1] = right;
+    ++node->count;
+}
+
+// Removes key index and child index + 1 from the inner node
+template <typename K, typename V, int NodeCap>
+void BTreeMap<K, V, NodeCap>::inner_erase(Inner *node, int index)
+{
+    std::destroy_at(node->keys() + index);
+    close_gap(node->keys(), node->count, index);
+    std::memmove(node->children + index + 1, node->children + index + 2,
+                 (node->count - index - 1) * sizeof(Node *));
+    --node->count;
+}
+
+// Pairs the underfull child with its left sibling (or right sibling
+// for the first child). If both fit in one node, the right one is
+// merged into the left one and removed from the parent along with
+// the separator between them. Otherwise one key moves across from the
+// sibling: directly for leaves (the separator becomes the right
+// leaf's new first key), or by rotating through the separator for
+// inner nodes.
+template <typename K, typename V, int NodeCap>
+void BTreeMap<K, V, NodeCap>::rebalance(Inner *parent, int index, bool leaf)
+{
+    int left_index = index > 0 ? index - 1 : 0;
+    bool left_underfull = index == 0;
+    K &separator = parent->keys()[left_index];
+
+    if (leaf)
+    {
+        Leaf *left = static_cast<Leaf *>(parent->children[left_index]);
+        Leaf *right = static_cast<Leaf *>(parent->children[left_index + 1]);
+        if (left->count + right->count <= NodeCap)
+        {
+            relocate(right->keys(), right->count, left->keys() + left->count);
+            relocate(right->values(), right->count, left->values() + left->count);
+            left->count += right->count;
+            left->next = right->next;
+            leaves.deallocate(right);
+            inner_erase(parent, left_index);
+        }
+        else if (left_underfull)
+        {
+            relocate(right->keys(), 1, left->keys() + left->count);
+            relocate(right->values(), 1, left->values() + left->count);
+            ++left->count;
+            close_gap(right->keys(), right->count, 0);
+            close_gap(right->values(), right->count, 0);
+            --right->count;
+            separator = right->keys()[0];
+        }
+        else
+        {
+            open_gap(right->keys(), right->count, 0);
+            open_gap(right->values(), right->count, 0);
+            relocate(left->keys() + left->count - 1, 1, right->keys());
+            relocate(left->values() + left->count - 1, 1, right->values());
+            ++right->count;
+            --left->count;
+            separator = right->keys()[0];
+        }
+        return;
+    }
+
+    Inner *left = static_cast<Inner *>(parent->children[left_index]);
+    Inner *right = static_cast<Inner *>(parent->children[left_index + 1]);
+    if (left->count + 1 + right->count <= NodeCap)
+    {
+        new (left->keys() + left->count) K(std::move(separator));
+        relocate(right->keys(), right->count, left->keys() + left->count + 1);
+        std::memcpy(left->children + left->count + 1, right->children,
+                    (right->count + 1) * sizeof(Node *));
+        left->count += 1 + right->count;
+        inners.deallocate(right);
+        inner_erase(parent, left_index);
+    }
+    else if (left_underfull)
+    {
+        new (left->keys() + left->count) K(std::move(separator));
+        left->children[left->count + 1] = right->children[0];
+        ++left->count;
+        separator = std::move(right->keys()[0]);
+        std::destroy_at(right->keys());
+        close_gap(right->keys(), right->count, 0);
+        std::memmove(right->children, right->children + 1, right->count * sizeof(Node *));
+        --right->count;
+    }
+    else
+    {
+        open_gap(right->keys(), right->count, 0);
+        new (right->keys()) K(std::move(separator));
+        std::memmove(right->children + 1, right->children,
+                     (right->count + 1) * sizeof(Node *));
+        right->children[0] = left->children[left->count];
+        ++right->count;
+        separator = std::move(left->keys()[left->count - 1]);
+        std::destroy_at(left->keys() + left->count - 1);
+        --left->count;
+    }
+}
+
+// Spreads the pairs evenly over the fewest leaves that hold them,
+// then builds each inner level the same way over the level below
+// (each node gets at least half its capacity when there are two or
+// more). The separator before a child is the first key below it.
+template <typename K, typename V, int NodeCap>
+void BTreeMap<K, V, NodeCap>::bulk_load(ArraySeq<K> &sorted_keys, ArraySeq<V> &sorted_values)
+{
+    int n = sorted_keys.size();
+    if (n == 0)
+        return;
+
+    // the nodes of the level being built on, and the leftmost leaf
+    // below each
+    ArraySeq<Node *> level;
+    ArraySeq<Leaf *> firsts;
+
+    int num_leaves = (n + NodeCap - 1) / NodeCap;
+    level.reserve(num_leaves);
+    firsts.reserve(num_leaves);
+    Leaf *prev = nullptr;
+    for (int i = 0, start = 0; i < num_leaves; ++i)
+    {
+        int end = static_cast<int>(static_cast<long>(n) * (i + 1) / num_leaves);
+        Leaf *leaf = new_leaf();
+        std::uninitialized_move(sorted_keys.begin() + start, sorted_keys.begin() + end,
+                                leaf->keys());
+        std::uninitialized_move(sorted_values.begin() + start, sorted_values.begin() + end,
+                                leaf->values());
+        leaf->count = end - start;
+        if (prev == nullptr)
+            first_leaf = leaf;
+        else
+            prev->next = leaf;
+        prev = leaf;
+        level.insert(leaf, i);
+        firsts.insert(leaf, i);
+        start = end;
+    }
+
+    while (level.size() > 1)
+    {
+        int m = level.size();
+        int num_parents = (m + NodeCap) / (NodeCap + 1);
+        ArraySeq<Node *> parents;
+        ArraySeq<Leaf *> parent_firsts;
+        parents.reserve(num_parents);
+        parent_firsts.reserve(num_parents);
+        for (int i = 0, start = 0; i < num_parents; ++i)
+        {
+            int end = static_cast<int>(static_cast<long>(m) * (i + 1) / num_parents);
+            Inner *inner = new_inner();
+            inner->children[0] = level[start];
+            for (int c = start + 1; c < end; ++c)
+            {
+                new (inner->keys() + inner->count) K(firsts[c]->keys()[0]);
+                inner->children[c - start] = level[c];
+                ++inner->count;
+            }
+            parents.insert(inner, i);
+            parent_firsts.insert(firsts[start], i);
+            start = end;
+        }
+        level = std::move(parents);
+        firsts = std::move(parent_firsts);
+        ++height;
+    }
+    root = level[0];
+    count = n;
+}
+
+// Destroys the keys (and values, in leaves) below and in the node
+template <typename K, typename V, int NodeCap>
+void BTreeMap<K, V, NodeCap>::destroy(Node *node, int level)
+{
+    if (level == 0)
+    {
+        Leaf *leaf = static_cast<Leaf *>(node);
+        std::destroy(leaf->values(), leaf->values() + leaf->count);
+    }
+    else
+    {
+        Inner *inner = static_cast<Inner *>(node);
+        for (int i = 0; i <= inner->count; ++i)
+            destroy(inner->children[i], level - 1);
+    }
+    std::destroy(node->keys(), node->keys() + node->count);
+}
+
+// Destroys the pairs and releases every node
+template <typename K, typename V, int NodeCap>
+void BTreeMap<K, V, NodeCap>::make_empty()
+{
+    if constexpr (!std::is_trivially_destructible<K>::value or
+                  !std::is_trivially_destructible<V>::value)
+        if (root != nullptr)
+            destroy(root, height);
+    leaves = NodePool<Leaf>();
+    inners = NodePool<Inner>();
+    root = nullptr;
+    first_leaf = nullptr;
+    height = count = 0;
+}
+
+static_assert(is_map<BTreeMap<int, int>, int, int>::value and
+              has_static_dispatch<BTreeMap<int, int>>::value,
+              "BTreeMap must satisfy the Map interface statically");
+
+#endif
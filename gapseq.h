@@ -0,0 +1,457 @@
+//---------------------------------------------------------------------------
+// NAME: Mason Manca
+// FILE: gapseq.h
+// DATE: Fall 2021
+// DESC: Gap buffer implementation of Sequence. The elements live in
+//       one array with a single run of free slots (the gap) kept at
+//       the position of the last insert or erase. An edit first moves
+//       the gap to its index, shifting only the elements between the
+//       old and new gap positions, so a run of inserts or erases at
+//       neighboring indexes costs O(1) each (amortized) instead of
+//       shifting the whole tail. Index access adds the gap size to
+//       indexes past the gap.
+//---------------------------------------------------------------------------
+
+#ifndef GAPSEQ_H
+#define GAPSEQ_H
+
+#include <stdexcept>
+#include <ostream>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <utility>
+#include "sequence.h"
+#include "arrayseq.h"
+#include "simdfind.h"
+#include "indexiterator.h"
+#include "interface.h"
+
+
+template<typename T>
+class GapSeq final : public Sequence<T>
+{
+public:
+
+  // Random access iterators over the elements (by index)
+  using iterator = IndexIterator<GapSeq*, T&>;
+  using const_iterator = IndexIterator<const GapSeq*, const T&>;
+
+  // Default constructor
+  GapSeq();
+
+  // Copy constructor
+  GapSeq(const GapSeq& rhs);
+
+  // Move constructor
+  GapSeq(GapSeq&& rhs);
+
+  // Copy assignment operator
+  GapSeq& operator=(const GapSeq& rhs);
+
+  // Move assignment operator
+  GapSeq& operator=(GapSeq&& rhs);
+
+  // Destructor
+  ~GapSeq();
+
+  // Returns the number of elements in the sequence
+  int size() const;
+
+  // Tests if the sequence is empty
+  bool empty() const;
+
+  // Returns a reference to the element at the index in the
+  // sequence. Throws out_of_range if index is invalid.
+  T& operator[](int index);
+
+  // Returns a constant address to the element at the index in the
+  // sequence. Throws out_of_range if index is invalid.
+  const T& operator[](int index) const;
+
+  // Returns the element at the index without checking the index.
+  // The index must be valid.
+  T& at_unchecked(int index);
+  const T& at_unchecked(int index) const;
+
+  // Extends the sequence by inserting the element at the given
+  // index. Throws out_of_range if the index is invalid.
+  void insert(const T& elem, int index);
+
+  // Same as above, moving the element into the sequence instead of
+  // copying it.
+  void insert(T&& elem, int index);
+
+  // Extends the sequence by constructing an element at the given
+  // index from the arguments (forwarded to T's constructor), and
+  // returns a reference to it. Throws out_of_range if the index is
+  // invalid.
+  template<typename... Args>
+  T& emplace(int index, Args&&... args);
+
+  // Shrinks the sequence by removing the element at the index in the
+  // sequence. Throws out_of_range if index is invalid.
+  void erase(int index);
+
+  // Returns true if the element is in the sequence, and false
+  // otherwise.
+  bool contains(const T& elem) const;
+
+  // Grows the array (if needed) so that it can hold at least n
+  // elements without reallocating.
+  void reserve(int n);
+
+  // Sorts the elements in the sequence using less than (<), by
+  // sorting them in an ArraySeq and moving them back.
+  void sort();
+
+  // Iterators over the elements
+  iterator begin();
+  iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
+
+private:
+
+  // raw storage, elements are in [0, gap_start) and [gap_end, cap)
+  T* array = nullptr;
+
+  // size of the array
+  int cap = 0;
+
+  // the gap of unconstructed slots [gap_start, gap_end)
+  int gap_start = 0;
+  int gap_end = 0;
+
+  // helper to move the gap so that it starts at the index
+  void move_gap(int index);
+
+  // helper to reallocate the array with the given capacity (at least
+  // size()), keeping the gap at the same index
+  void reallocate(int new_cap);
+
+  // helper to destroy the elements and free the array
+  void make_empty();
+
+};
+
+
+template<typename T>
+std::ostream& operator<<(std::ostream& stream, const GapSeq<T>& seq)
+{
+  for(int i = 0; i < seq.size(); ++i)
+  {
+    if(i > 0)
+      stream << ", ";
+    stream << seq.at_unchecked(i);
+  }
+  return stream;
+}
+
+
+// Default constructor
+template<typename T>
+GapSeq<T>::GapSeq()
+{
+}
+
+// Copy constructor
+template<typename T>
+GapSeq<T>::GapSeq(const GapSeq& rhs)
+{
+  *this = rhs;
+}
+
+// Move constructor
+template<typename T>
+GapSeq<T>::GapSeq(GapSeq&& rhs)
+{
+  *this = std::move(rhs);
+}
+
+// Copy assignment operator
+template<typename T>
+GapSeq<T>& GapSeq<T>::operator=(const GapSeq& rhs)
+{
+  if(this != &rhs)
+  {
+    make_empty();
+    reserve(rhs.size());
+    for(int i = 0; i < rhs.size(); ++i)
+      emplace(i, rhs.at_unchecked(i));
+  }
+  return *this;
+}
+
+// Move assignment operator
+template<typename T>
+GapSeq<T>& GapSeq<T>::operator=(GapSeq&& rhs)
+{
+  if(this != &rhs)
+  {
+    make_empty();
+    array = rhs.array;
+    cap = rhs.cap;
+    gap_start = rhs.gap_start;
+    gap_end = rhs.gap_end;
+    rhs.array = nullptr;
+    rhs.cap = rhs.gap_start = rhs.gap_end = 0;
+  }
+  return *this;
+}
+
+// Destructor
+template<typename T>
+GapSeq<T>::~GapSeq()
+{
+  make_empty();
+}
+
+// Returns the number of elements in the sequence
+template<typename T>
+int GapSeq<T>::size() const
+{
+  return cap - (gap_end - gap_start);
+}
+
+// Tests if the sequence is empty
+template<typename T>
+bool GapSeq<T>::empty() const
+{
+  return size() == 0;
+}
+
+// Returns a reference to the element at the index in the sequence.
+// Throws out_of_range if index is invalid.
+template<typename T>
+T& GapSeq<T>::operator[](int index)
+{
+  if(index >= size() or index < 0)
+    throw std::out_of_range("Out of range in the [] nonconst");
+  return at_unchecked(index);
+}
+
+// Returns a constant address to the element at the index in the
+// sequence. Throws out_of_range if index is invalid.
+template<typename T>
+const T& GapSeq<T>::operator[](int index) const
+{
+  if(index >= size() or index < 0)
+    throw std::out_of_range("Out of range in the [] const");
+  return at_unchecked(index);
+}
+
+// Returns the element at the index without checking the index
+template<typename T>
+T& GapSeq<T>::at_unchecked(int index)
+{
+  return array[index < gap_start ? index : index + (gap_end - gap_start)];
+}
+
+template<typename T>
+const T& GapSeq<T>::at_unchecked(int index) const
+{
+  return array[index < gap_start ? index : index + (gap_end - gap_start)];
+}
+
+// Extends the sequence by inserting the element at the given index.
+// Throws out_of_range if the index is invalid.
+template<typename T>
+void GapSeq<T>::insert(const T& elem, int index)
+{
+  emplace(index, elem);
+}
+
+// Extends the sequence by moving the element in at the given index.
+// Throws out_of_range if the index is invalid.
+template<typename T>
+void GapSeq<T>::insert(T&& elem, int index)
+{
+  emplace(index, std::move(elem));
+}
+
+// Constructs an element at the given index, at the start of the gap
+// after moving the gap there. Throws out_of_range if the index is
+// invalid.
+template<typename T>
+template<typename... Args>
+T& GapSeq<T>::emplace(int index, Args&&... args)
+{
+  if(index > size() or index < 0)
+    throw std::out_of_range("Out of range in insert");
+
+  // the arguments may refer into the sequence, which the moves below
+  // would invalidate, so the element is built first
+  T elem(std::forward<Args>(args)...);
+  if(gap_start == gap_end)
+    reallocate(cap == 0 ? 1 : cap * 2);
+  move_gap(index);
+  new (array + gap_start) T(std::move(elem));
+  return array[gap_start++];
+}
+
+// Shrinks the sequence by removing the element at the index, the
+// first one after the gap once the gap is moved there. Throws
+// out_of_range if index is invalid.
+template<typename T>
+void GapSeq<T>::erase(int index)
+{
+  if(index >= size() or index < 0)
+    throw std::out_of_range("Out of range in erase");
+
+  move_gap(index);
+  std::destroy_at(array + gap_end);
+  ++gap_end;
+}
+
+// Returns true if the element is in the sequence, and false
+// otherwise. Searches the elements on each side of the gap.
+template<typename T>
+bool GapSeq<T>::contains(const T& elem) const
+{
+  return simd_find(array, gap_start, elem) >= 0 or
+         simd_find(array + gap_end, cap - gap_end, elem) >= 0;
+}
+
+// Grows the array to hold at least n elements
+template<typename T>
+void GapSeq<T>::reserve(int n)
+{
+  if(n > cap)
+    reallocate(n);
+}
+
+// Sorts by moving the elements into an ArraySeq (which picks radix
+// sort or introsort), sorting, and moving them back in order
+template<typename T>
+void GapSeq<T>::sort()
+{
+  int n = size();
+  if(n < 2)
+    return;
+  ArraySeq<T> sorted;
+  sorted.reserve(n);
+  for(int i = 0; i < n; ++i)
+    sorted.insert(std::move(at_unchecked(i)), i);
+  sorted.sort();
+  for(int i = 0; i < n; ++i)
+    at_unchecked(i) = std::move(sorted.at_unchecked(i));
+}
+
+// Iterators over the elements
+template<typename T>
+typename GapSeq<T>::iterator GapSeq<T>::begin()
+{
+  return iterator(this, 0);
+}
+
+template<typename T>
+typename GapSeq<T>::iterator GapSeq<T>::end()
+{
+  return iterator(this, size());
+}
+
+template<typename T>
+typename GapSeq<T>::const_iterator GapSeq<T>::begin() const
+{
+  return const_iterator(this, 0);
+}
+
+template<typename T>
+typename GapSeq<T>::const_iterator GapSeq<T>::end() const
+{
+  return const_iterator(this, size());
+}
+
+// Moves the gap to start at the index by moving the elements between
+// the two positions across it (memmove for bitwise movable types).
+// Each element is moved into a free slot and its old slot is
+// destroyed, so the slots left behind become the gap. An empty gap
+// (a full array) has nothing to move across, so it is just relocated.
+template<typename T>
+void GapSeq<T>::move_gap(int index)
+{
+  int gap = gap_end - gap_start;
+  if(gap == 0)
+  {
+    gap_start = gap_end = index;
+    return;
+  }
+  if(index < gap_start)
+  {
+    // [index, gap_start) moves right to [index + gap, gap_end)
+    if constexpr (is_bitwise_movable<T>::value)
+      std::memmove(static_cast<void*>(array + index + gap), array + index,
+                   (gap_start - index) * sizeof(T));
+    else
+      for(int p = gap_start - 1; p >= index; --p)
+      {
+        new (array + p + gap) T(std::move(array[p]));
+        std::destroy_at(array + p);
+      }
+  }
+  else if(index > gap_start)
+  {
+    // [gap_end, index + gap) moves left to [gap_start, index)
+    if constexpr (is_bitwise_movable<T>::value)
+      std::memmove(static_cast<void*>(array + gap_start), array + gap_end,
+                   (index - gap_start) * sizeof(T));
+    else
+      for(int p = gap_end; p < index + gap; ++p)
+      {
+        new (array + p - gap) T(std::move(array[p]));
+        std::destroy_at(array + p);
+      }
+  }
+  gap_start = index;
+  gap_end = index + gap;
+}
+
+// Reallocates the array, with the elements after the gap moved to the
+// end of the new array
+template<typename T>
+void GapSeq<T>::reallocate(int new_cap)
+{
+  T* new_array = std::allocator<T>().allocate(new_cap);
+  int tail = cap - gap_end;
+  int new_gap_end = new_cap - tail;
+  if constexpr (is_bitwise_movable<T>::value)
+  {
+    if(gap_start > 0)
+      std::memcpy(static_cast<void*>(new_array), array, gap_start * sizeof(T));
+    if(tail > 0)
+      std::memcpy(static_cast<void*>(new_array + new_gap_end), array + gap_end,
+                  tail * sizeof(T));
+  }
+  else
+  {
+    std::uninitialized_move(array, array + gap_start, new_array);
+    std::uninitialized_move(array + gap_end, array + cap, new_array + new_gap_end);
+    std::destroy(array, array + gap_start);
+    std::destroy(array + gap_end, array + cap);
+  }
+  if(array != nullptr)
+    std::allocator<T>().deallocate(array, cap);
+  array = new_array;
+  cap = new_cap;
+  gap_end = new_gap_end;
+}
+
+// Destroys the elements and frees the array
+template<typename T>
+void GapSeq<T>::make_empty()
+{
+  std::destroy(array, array + gap_start);
+  std::destroy(array + gap_end, array + cap);
+  if(array != nullptr)
+    std::allocator<T>().deallocate(array, cap);
+  array = nullptr;
+  cap = gap_start = gap_end = 0;
+}
+
+static_assert(is_sequence<GapSeq<int>, int>::value and
+              has_static_dispatch<GapSeq<int>>::value,
+              "GapSeq must satisfy the Sequence interface statically");
+
+
+#endif
@@ -0,0 +1,540 @@
+//---------------------------------------------------------------------------
+// NAME: Mason Manca
+// FILE: hashmap.h
+// DATE: Fall 2021
+// DESC: Open addressing hash map. The pairs live in one flat array of
+//       slots, and a parallel array holds one control byte per slot:
+//       empty, or 7 bits of the key's hash. A lookup starts at the
+//       key's home slot and scans forward (linear probing) 16 control
+//       bytes at a time, comparing all 16 to the hash bits with one
+//       SSE2 compare, and only compares keys whose bits match. The
+//       control array repeats its first 15 bytes past the end so a
+//       group read near the end wraps around without a branch.
+//       Erasing moves later pairs of the run back into the hole when
+//       the hole would cut them off from their home slots (backward
+//       shift), so there are no tombstones and every probe ends at
+//       the first empty slot. The table doubles when it
+//       would become more than 7/8 full. Ordered key queries collect
+//       the keys and sort them.
+//---------------------------------------------------------------------------
+
+#ifndef HASHMAP_H
+#define HASHMAP_H
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include "map.h"
+#include "interface.h"
+#include "arrayseq.h"
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#define HASHMAP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+template <typename K, typename V, typename Hash = std::hash<K>>
+class HashMap final : public Map<K, V>
+{
+public:
+    // Default constructor
+    HashMap();
+
+    // Copy constructor
+    HashMap(const HashMap &rhs);
+
+    // Move constructor
+    HashMap(HashMap &&rhs);
+
+    // Copy assignment operator
+    HashMap &operator=(const HashMap &rhs);
+
+    // Move assignment operator
+    HashMap &operator=(HashMap &&rhs);
+
+    // Destructor
+    ~HashMap();
+
+    // Returns the number of key-value pairs in the map
+    int size() const;
+
+    // Tests if the map is empty
+    bool empty() const;
+
+    // Allows values associated with a key to be updated. Throws
+    // out_of_range if the given key is not in the collection.
+    V &operator[](const K &key);
+
+    // Returns the value for a given key. Throws out_of_range if the
+    // given key is not in the collection.
+    const V &operator[](const K &key) const;
+
+    // Extends the collection by adding the given key-value pair (if
+    // the key is not already present).
+    void insert(const K &key, const V &value);
+
+    // Same as above, moving the key and value into the collection
+    // instead of copying them.
+    void insert(K &&key, V &&value);
+
+    // Adds the key with a value constructed in place from the
+    // arguments (forwarded to V's constructor) if the key is not
+    // already in the collection. Returns true if the pair was added,
+    // and false (without using the arguments) otherwise.
+    template <typename... Args>
+    bool try_emplace(const K &key, Args &&...args);
+    template <typename... Args>
+    bool try_emplace(K &&key, Args &&...args);
+
+    // Shrinks the collection by removing the key-value pair with the
+    // given key. Throws out_of_range if the given key is not in the
+    // collection.
+    void erase(const K &key);
+
+    // Returns true if the key is in the collection, and false
+    // otherwise.
+    bool contains(const K &key) const;
+
+    // Returns the keys k in the collection such that k1 <= k <= k2
+    // (collected from the table, then sorted)
+    ArraySeq<K> find_keys(const K &k1, const K &k2) const;
+
+    // Returns the keys in the collection in ascending sorted order
+    // (collected from the table, then sorted)
+    ArraySeq<K> sorted_keys() const;
+
+    // Grows the table (if needed) so that it can hold n pairs without
+    // rehashing
+    void reserve(int n);
+
+private:
+    // control bytes compared at once, and the control byte of an
+    // empty slot (full slots hold 7 hash bits, 0 to 127)
+    static constexpr int group_width = 16;
+    static constexpr signed char empty_ctrl = -128;
+
+    // smallest table size
+    static constexpr int min_cap = 16;
+
+    // slot storage (a slot holds a pair only if its control byte is
+    // not empty)
+    std::pair<K, V> *slots = nullptr;
+
+    // control bytes, cap of them followed by copies of the first
+    // group_width - 1
+    signed char *ctrl = nullptr;
+
+    // number of slots (0 or a power of two, at least min_cap)
+    int cap = 0;
+
+    // number of pairs
+    int count = 0;
+
+    // the key hash function
+    Hash hasher;
+
+    // Bit i is set if control byte pos + i (wrapping) equals c
+    unsigned match_group(int pos, signed char c) const;
+
+    // helper to hash a key, mixing the bits so that both the home slot
+    // (high bits) and the control byte (low 7 bits) are well spread
+    std::uint64_t hash(const K &key) const;
+
+    // helper to return the key's home slot given its hash
+    int home_slot(std::uint64_t h) const;
+
+    // helper to return the key's slot, or -1 if it is not present
+    int find_slot(const K &key) const;
+
+    // helper to mark the first empty slot on the probe sequence of the
+    // hash as full and return it (the caller constructs the pair)
+    int claim_slot(std::uint64_t h);
+
+    // helper to set a control byte and its copy past the end
+    void set_ctrl(int index, signed char c);
+
+    // helper to move the pairs into a new table of the given size
+    void rehash(int new_cap);
+
+    // helper for insert and both try_emplace overloads (KArg is
+    // const K& or K)
+    template <typename KArg, typename... Args>
+    bool emplace_unique(KArg &&key, Args &&...args);
+
+    // helper to destroy the pairs and free the table
+    void make_empty();
+};
+
+
+// Default constructor
+template <typename K, typename V, typename Hash>
+HashMap<K, V, Hash>::HashMap()
+{
+}
+
+// Copy constructor
+template <typename K, typename V, typename Hash>
+HashMap<K, V, Hash>::HashMap(const HashMap &rhs)
+{
+    *this = rhs;
+}
+
+// Move constructor
+template <typename K, typename V, typename Hash>
+HashMap<K, V, Hash>::HashMap(HashMap &&rhs)
+{
+    *this = std::move(rhs);
+}
+
+// Copy assignment operator, reinserting each pair of rhs
+template <typename K, typename V, typename Hash>
+HashMap<K, V, Hash> &HashMap<K, V, Hash>::operator=(const HashMap &rhs)
+{
+    if (this != &rhs)
+    {
+        make_empty();
+        hasher = rhs.hasher;
+        reserve(rhs.count);
+        for (int i = 0; i < rhs.cap; ++i)
+            if (rhs.ctrl[i] != empty_ctrl)
+            {
+                int index = claim_slot(hash(rhs.slots[i].first));
+                new (slots + index) std::pair<K, V>(rhs.slots[i]);
+                ++count;
+            }
+    }
+    return *this;
+}
+
+// Move assignment operator
+template <typename K, typename V, typename Hash>
+HashMap<K, V, Hash> &HashMap<K, V, Hash>::operator=(HashMap &&rhs)
+{
+    if (this != &rhs)
+    {
+        make_empty();
+        hasher = std::move(rhs.hasher);
+        slots = rhs.slots;
+        ctrl = rhs.ctrl;
+        cap = rhs.cap;
+        count = rhs.count;
+        rhs.slots = nullptr;
+        rhs.ctrl = nullptr;
+        rhs.cap = rhs.count = 0;
+    }
+    return *this;
+}
+
+// Destructor
+template <typename K, typename V, typename Hash>
+HashMap<K, V, Hash>::~HashMap()
+{
+    make_empty();
+}
+
+// Returns the number of key-value pairs in the map
+template <typename K, typename V, typename Hash>
+int HashMap<K, V, Hash>::size() const
+{
+    return count;
+}
+
+// Tests if the map is empty
+template <typename K, typename V, typename Hash>
+bool HashMap<K, V, Hash>::empty() const
+{
+    return count == 0;
+}
+
+// Allows values associated with a key to be updated. Throws
+// out_of_range if the given key is not in the collection.
+template <typename K, typename V, typename Hash>
+V &HashMap<K, V, Hash>::operator[](const K &key)
+{
+    int index = find_slot(key);
+    if (index < 0)
+        throw std::out_of_range("Out of range in the [] nonconst");
+    return slots[index].second;
+}
+
+// Returns the value for a given key. Throws out_of_range if the
+// given key is not in the collection.
+template <typename K, typename V, typename Hash>
+const V &HashMap<K, V, Hash>::operator[](const K &key) const
+{
+    int index = find_slot(key);
+    if (index < 0)
+        throw std::out_of_range("Out of range in the [] const");
+    return slots[index].second;
+}
+
+// Extends the collection by adding the given key-value pair
+template <typename K, typename V, typename Hash>
+void HashMap<K, V, Hash>::insert(const K &key, const V &value)
+{
+    emplace_unique(key, value);
+}
+
+// Extends the collection by moving the given key-value pair in
+template <typename K, typename V, typename Hash>
+void HashMap<K, V, Hash>::insert(K &&key, V &&value)
+{
+    emplace_unique(std::move(key), std::move(value));
+}
+
+// Adds the key with a value constructed in place from the arguments
+// if the key is not already in the collection.
+template <typename K, typename V, typename Hash>
+template <typename... Args>
+bool HashMap<K, V, Hash>::try_emplace(const K &key, Args &&...args)
+{
+    return emplace_unique(key, std::forward<Args>(args)...);
+}
+
+template <typename K, typename V, typename Hash>
+template <typename... Args>
+bool HashMap<K, V, Hash>::try_emplace(K &&key, Args &&...args)
+{
+    return emplace_unique(std::move(key), std::forward<Args>(args)...);
+}
+
+// Returns false if the key is in the collection, otherwise adds the
+// key (forwarded) with a value constructed from the arguments. The
+// pair is built before the table can grow, since the arguments may
+// refer into the table.
+template <typename K, typename V, typename Hash>
+template <typename KArg, typename... Args>
+bool HashMap<K, V, Hash>::emplace_unique(KArg &&key, Args &&...args)
+{
+    if (find_slot(key) >= 0)
+        return false;
+    std::pair<K, V> elem(std::piecewise_construct,
+                         std::forward_as_tuple(std::forward<KArg>(key)),
+                         std::forward_as_tuple(std::forward<Args>(args)...));
+    reserve(count + 1);
+    int index = claim_slot(hash(elem.first));
+    new (slots + index) std::pair<K, V>(std::move(elem));
+    ++count;
+    return true;
+}
+
+// Removes the key's pair, leaving a hole, then scans the rest of the
+// run up to the next empty slot. A pair whose home slot is not
+// (cyclically) between the hole and itself would be cut off from its
+// home by the hole, so it moves back into the hole, and its old slot
+// becomes the hole. This keeps every pair reachable from its home
+// slot without passing an empty slot.
+template <typename K, typename V, typename Hash>
+void HashMap<K, V, Hash>::erase(const K &key)
+{
+    int hole = find_slot(key);
+    if (hole < 0)
+        throw std::out_of_range("Out of range in erase");
+
+    int mask = cap - 1;
+    std::destroy_at(slots + hole);
+    for (int next = (hole + 1) & mask; ctrl[next] != empty_ctrl; next = (next + 1) & mask)
+    {
+        int home = home_slot(hash(slots[next].first));
+        bool reachable = hole <= next ? (hole < home and home <= next)
+                                      : (hole < home or home <= next);
+        if (reachable)
+            continue;
+        new (slots + hole) std::pair<K, V>(std::move(slots[next]));
+        std::destroy_at(slots + next);
+        set_ctrl(hole, ctrl[next]);
+        hole = next;
+    }
+    set_ctrl(hole, empty_ctrl);
+    --count;
+}
+
+// Returns true if the key is in the collection, and false
+// otherwise.
+template <typename K, typename V, typename Hash>
+bool HashMap<K, V, Hash>::contains(const K &key) const
+{
+    return find_slot(key) >= 0;
+}
+
+// Returns the keys k in the collection such that k1 <= k <= k2
+template <typename K, typename V, typename Hash>
+ArraySeq<K> HashMap<K, V, Hash>::find_keys(const K &k1, const K &k2) const
+{
+    ArraySeq<K> found;
+    for (int i = 0; i < cap; ++i)
+        if (ctrl[i] != empty_ctrl and !(slots[i].first < k1) and !(k2 < slots[i].first))
+            found.insert(slots[i].first, found.size());
+    found.sort();
+    return found;
+}
+
+// Returns the keys in the collection in ascending sorted order
+template <typename K, typename V, typename Hash>
+ArraySeq<K> HashMap<K, V, Hash>::sorted_keys() const
+{
+    ArraySeq<K> keys;
+    keys.reserve(count);
+    for (int i = 0; i < cap; ++i)
+        if (ctrl[i] != empty_ctrl)
+            keys.insert(slots[i].first, keys.size());
+    keys.sort();
+    return keys;
+}
+
+// Grows the table to the smallest power of two that holds n pairs
+// at most 7/8 full
+template <typename K, typename V, typename Hash>
+void HashMap<K, V, Hash>::reserve(int n)
+{
+    if (static_cast<long>(n) * 8 <= static_cast<long>(cap) * 7)
+        return;
+    int new_cap = cap == 0 ? min_cap : cap;
+    while (static_cast<long>(n) * 8 > static_cast<long>(new_cap) * 7)
+        new_cap *= 2;
+    rehash(new_cap);
+}
+
+// Bit i is set if control byte pos + i equals c. The group may run
+// past cap into the copied bytes, which stand for slots 0 to 14.
+template <typename K, typename V, typename Hash>
+unsigned HashMap<K, V, Hash>::match_group(int pos, signed char c) const
+{
+#ifdef HASHMAP_SSE2
+    __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl + pos));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(c)));
+#else
+    unsigned bits = 0;
+    for (int i = 0; i < group_width; ++i)
+        if (ctrl[pos + i] == c)
+            bits |= 1u << i;
+    return bits;
+#endif
+}
+
+// Mixes the bits of the hash (the murmur3 finalizer), since hashes
+// such as std::hash<int> are the identity
+template <typename K, typename V, typename Hash>
+std::uint64_t HashMap<K, V, Hash>::hash(const K &key) const
+{
+    std::uint64_t h = hasher(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// The home slot comes from the hash bits above the 7 control bits
+template <typename K, typename V, typename Hash>
+int HashMap<K, V, Hash>::home_slot(std::uint64_t h) const
+{
+    return static_cast<int>(h >> 7) & (cap - 1);
+}
+
+// Scans from the home slot a group at a time, comparing keys only
+// where the control byte matches, until a group has an empty slot
+template <typename K, typename V, typename Hash>
+int HashMap<K, V, Hash>::find_slot(const K &key) const
+{
+    if (count == 0)
+        return -1;
+    std::uint64_t h = hash(key);
+    signed char bits = static_cast<signed char>(h & 0x7F);
+    int mask = cap - 1;
+    for (int pos = home_slot(h);; pos = (pos + group_width) & mask)
+    {
+        for (unsigned hits = match_group(pos, bits); hits != 0; hits &= hits - 1)
+        {
+            int index = (pos + __builtin_ctz(hits)) & mask;
+            if (slots[index].first == key)
+                return index;
+        }
+        if (match_group(pos, empty_ctrl) != 0)
+            return -1;
+    }
+}
+
+// Finds the first empty slot from the home slot (there is always one,
+// since the table is never full) and stores the hash bits in it
+template <typename K, typename V, typename Hash>
+int HashMap<K, V, Hash>::claim_slot(std::uint64_t h)
+{
+    int mask = cap - 1;
+    int pos = home_slot(h);
+    unsigned empties = match_group(pos, empty_ctrl);
+    while (empties == 0)
+    {
+        pos = (pos + group_width) & mask;
+        empties = match_group(pos, empty_ctrl);
+    }
+    int index = (pos + __builtin_ctz(empties)) & mask;
+    set_ctrl(index, static_cast<signed char>(h & 0x7F));
+    return index;
+}
+
+// Sets the control byte, and its copy if it is one of the first
+// group_width - 1
+template <typename K, typename V, typename Hash>
+void HashMap<K, V, Hash>::set_ctrl(int index, signed char c)
+{
+    ctrl[index] = c;
+    if (index < group_width - 1)
+        ctrl[cap + index] = c;
+}
+
+// Allocates the new table and moves each pair to its slot there
+template <typename K, typename V, typename Hash>
+void HashMap<K, V, Hash>::rehash(int new_cap)
+{
+    std::pair<K, V> *old_slots = slots;
+    signed char *old_ctrl = ctrl;
+    int old_cap = cap;
+
+    slots = std::allocator<std::pair<K, V>>().allocate(new_cap);
+    ctrl = new signed char[new_cap + group_width - 1];
+    std::memset(ctrl, empty_ctrl, new_cap + group_width - 1);
+    cap = new_cap;
+
+    for (int i = 0; i < old_cap; ++i)
+        if (old_ctrl[i] != empty_ctrl)
+        {
+            int index = claim_slot(hash(old_slots[i].first));
+            new (slots + index) std::pair<K, V>(std::move(old_slots[i]));
+            std::destroy_at(old_slots + i);
+        }
+    if (old_slots != nullptr)
+    {
+        std::allocator<std::pair<K, V>>().deallocate(old_slots, old_cap);
+        delete[] old_ctrl;
+    }
+}
+
+// Destroys the pairs and frees the table
+template <typename K, typename V, typename Hash>
+void HashMap<K, V, Hash>::make_empty()
+{
+    for (int i = 0; i < cap; ++i)
+        if (ctrl[i] != empty_ctrl)
+            std::destroy_at(slots + i);
+    if (slots != nullptr)
+    {
+        std::allocator<std::pair<K, V>>().deallocate(slots, cap);
+        delete[] ctrl;
+    }
+    slots = nullptr;
+    ctrl = nullptr;
+    cap = count = 0;
+}
+
+static_assert(is_map<HashMap<int, int>, int, int>::value and
+              has_static_dispatch<HashMap<int, int>>::value,
+              "HashMap must satisfy the Map interface statically");
+
+#endif
@@ -9,7 +9,25 @@
 //       save this data to a file, run the command:
 //          ./hw5_perf > output.dat
 //       This file can then be used by the plotting script to generate
-//       the corresponding performance graphs.
+//       the corresponding performance graphs. Additional benchmark
+//       suites are selected by name, for example:
+//          ./hw5_perf shift > shift.dat
+//       Suites: shift (ArraySeq insert/erase shifting at 1M+ elements)
+//               sort  (ArraySeq sorts on ordered/reversed/shuffled data)
+//               threads (parallel merge sort scaling versus cores)
+//               radix (radix sort versus comparison sorts, 1M-10M)
+//               dispatch (virtual Map& calls versus static calls)
+//               strings (copy versus move versus emplace of string values)
+//               views (BinSearchMap key views versus copied key sequences)
+//               linked (LinkedSeq pooled versus new-per-node nodes)
+//               middle (middle inserts and scans: array, linked, unrolled)
+//               tiered (BinSearchMap over ArraySeq versus TieredSeq)
+//               gap (BinSearchMap over ArraySeq versus GapSeq)
+//               ring (BinSearchMap over ArraySeq versus RingSeq)
+//               layout (BinSearchMap pair layout versus split layout)
+//               static (BinSearchMap versus StaticMap lookups, 1K-100M)
+//               btree (BTreeMap versus BinSearchMap, 1M-100M keys)
+//               tree  (TreeMap versus BTreeMap versus BinSearchMap mixes)
 //---------------------------------------------------------------------------
 
 #include <iostream>
@@ -19,12 +37,24 @@
 #include <functional>
 #include <vector>
 #include <cassert>
+#include <string>
+#include <utility>
+#include <thread>
 #include "util.h"
 #include "arrayseq.h"
+#include "linkedseq.h"
+#include "unrolledseq.h"
+#include "tieredseq.h"
+#include "gapseq.h"
+#include "ringseq.h"
 #include "map.h"
 #include "arraymap.h"
 #include "linkedmap.h"
 #include "binsearchmap.h"
+#include "staticmap.h"
+#include "hashmap.h"
+#include "btreemap.h"
+#include "treemap.h"
 
 
 using namespace std;
@@ -37,12 +67,48 @@ double timed_erase(Map<int,int>& m, int key);
 double timed_contains(const Map<int,int>& m, int key);
 double timed_find_range(const Map<int,int>& m, int key1, int key2);
 double timed_sorted_keys(const Map<int,int>& m);
+double timed_lookup(const Map<int,int>& m, const ArraySeq<int>& keys, int n);
+
+// benchmark suites
+void shift_perf();
+void sort_perf();
+void threads_perf();
+void radix_perf();
+void dispatch_perf();
+void strings_perf();
+void views_perf();
+void linked_perf();
+void middle_perf();
+void tiered_perf();
+void gap_perf();
+void ring_perf();
+void layout_perf();
+void static_perf();
+void btree_perf();
+void tree_perf();
+
+template<typename T>
+double timed_seq_insert(ArraySeq<T>& s, int index, const T& elem);
+template<typename T>
+double timed_seq_erase(ArraySeq<T>& s, int index);
+double timed_sort(ArraySeq<int>& s, function<void(ArraySeq<int>&)> sort_fn,
+                  function<void(Sequence<int>&)> reset);
+template<typename M>
+double timed_contains_batch(const M& m, const ArraySeq<int>& keys, int n);
+template<typename M>
+double timed_string_load(const ArraySeq<int>& keys, int n,
+                         function<void(M&, int)> add);
+template<typename S>
+double timed_linked_churn(int n, long& traversal);
+template<typename S>
+double timed_middle_inserts(int n, double& scan);
 
 // test parameters
 const int start = 0;
 const int step = 2000;
 const int stop = 20000; 
 const int runs = 3;
+const int lookups = 1000;
 
 
 int main(int argc, char* argv[])
@@ -51,6 +117,48 @@ int main(int argc, char* argv[])
   cout << fixed << showpoint;
   cout << setprecision(2);
 
+  // run a named benchmark suite instead of the map comparison
+  if (argc > 1) {
+    string suite = argv[1];
+    if (suite == "shift")
+      shift_perf();
+    else if (suite == "sort")
+      sort_perf();
+    else if (suite == "threads")
+      threads_perf();
+    else if (suite == "radix")
+      radix_perf();
+    else if (suite == "dispatch")
+      dispatch_perf();
+    else if (suite == "strings")
+      strings_perf();
+    else if (suite == "views")
+      views_perf();
+    else if (suite == "linked")
+      linked_perf();
+    else if (suite == "middle")
+      middle_perf();
+    else if (suite == "tiered")
+      tiered_perf();
+    else if (suite == "gap")
+      gap_perf();
+    else if (suite == "ring")
+      ring_perf();
+    else if (suite == "layout")
+      layout_perf();
+    else if (suite == "static")
+      static_perf();
+    else if (suite == "btree")
+      btree_perf();
+    else if (suite == "tree")
+      tree_perf();
+    else {
+      cerr << "unknown benchmark suite: " << suite << endl;
+      return 1;
+    }
+    return 0;
+  }
+
   // output data header
   cout << "# All times in milliseconds (msec)" << endl;
   cout << "# Column 1 = input data size" << endl;
@@ -75,9 +183,22 @@ int main(int argc, char* argv[])
   cout << "# Column 15 = array map sorted keys" << endl;
   cout << "# Column 16 = linked map sorted keys" << endl;
 
+  cout << "# Column 17 = binsearch map lookup (" << lookups << " keys)" << endl;
+  cout << "# Column 18 = array map lookup (" << lookups << " keys)" << endl;
+  cout << "# Column 19 = linked map lookup (" << lookups << " keys)" << endl;
+
+  cout << "# Column 20 = hash map insert" << endl;
+  cout << "# Column 21 = hash map erase" << endl;
+  cout << "# Column 22 = hash map contains" << endl;
+  cout << "# Column 23 = hash map find range" << endl;
+  cout << "# Column 24 = hash map sorted keys" << endl;
+  cout << "# Column 25 = hash map lookup (" << lookups << " keys)" << endl;
+
 
   // generate shuffled data
   ArraySeq<int> keys, vals;
+  keys.reserve(stop);
+  vals.reserve(stop);
   for (int i = 2; i <= stop*2; i += 2) {
     keys.insert(i, keys.size());
     vals.insert(i, vals.size());
@@ -91,10 +212,12 @@ int main(int argc, char* argv[])
     BinSearchMap<int,int> m1;
     ArrayMap<int,int> m2;
     LinkedMap<int,int> m3;
+    HashMap<int,int> m4;
     for (int i = 0; i < n; ++i) {
       m1.insert(keys[i], vals[i]);
       m2.insert(keys[i], vals[i]);
       m3.insert(keys[i], vals[i]);
+      m4.insert(keys[i], vals[i]);
     }
 
     int min = 2;
@@ -114,26 +237,38 @@ int main(int argc, char* argv[])
     double c6 = timed_erase(m2, med + 1);
     double c4 = timed_insert(m3, med + 1);
     double c7 = timed_erase(m3, med + 1);
+    double c20 = timed_insert(m4, med + 1);
+    double c21 = timed_erase(m4, med + 1);
 
     assert(m1.size() == n);
     assert(m2.size() == n);
     assert(m3.size() == n);
+    assert(m4.size() == n);
 
     // contains end
     double c8 = timed_contains(m1, max + 1);
     double c9 = timed_contains(m2, max + 1);
     double c10 = timed_contains(m3, max + 1);
+    double c22 = timed_contains(m4, max + 1);
 
 
     // key range (1/20th of values)
     double c11 = timed_find_range(m1, med, med + (n/20));
     double c12 = timed_find_range(m2, med, med + (n/20));
     double c13 = timed_find_range(m3, med, med + (n/20));
+    double c23 = timed_find_range(m4, med, med + (n/20));
     
     // sort
     double c14 = timed_sorted_keys(m1);
     double c15 = timed_sorted_keys(m2);
     double c16 = timed_sorted_keys(m3);
+    double c24 = timed_sorted_keys(m4);
+
+    // lookup of existing keys
+    double c17 = timed_lookup(m1, keys, n);
+    double c18 = timed_lookup(m2, keys, n);
+    double c19 = timed_lookup(m3, keys, n);
+    double c25 = timed_lookup(m4, keys, n);
     
     cout << n
          << " " << c2 << " " << c3 << " " << c4
@@ -141,6 +276,9 @@ int main(int argc, char* argv[])
          << " " << c8 << " " << c9 << " " << c10 
          << " " << c11 << " " << c12 << " " << c13
          << " " << c14 << " " << c15 << " " << c16
+         << " " << c17 << " " << c18 << " " << c19
+         << " " << c20 << " " << c21 << " " << c22
+         << " " << c23 << " " << c24 << " " << c25
          << endl;
   }
   
@@ -208,6 +346,955 @@ double timed_sorted_keys(const Map<int,int>& m)
   return (total/1000) / runs;
 }
 
+// looks up a fixed number of keys, cycling through the n loaded keys
+double timed_lookup(const Map<int,int>& m, const ArraySeq<int>& keys, int n)
+{
+  if (n == 0)
+    return 0;
+  double total = 0;
+  long sum = 0;
+  for (int r = 0; r < runs; ++r) {
+    auto t0 = high_resolution_clock::now();
+    for (int i = 0; i < lookups; ++i)
+      sum += m[keys[(i * 7919) % n]];
+    auto t1 = high_resolution_clock::now();
+    total += duration_cast<microseconds>(t1 - t0).count();
+  }
+  assert(sum > 0);
+  return (total/1000) / runs;
+}
+
+//----------------------------------------------------------------------
+// ArraySeq shifting: per-operation insert and erase cost at the front
+// and middle of large int and pair<int,int> sequences
+//----------------------------------------------------------------------
+void shift_perf()
+{
+  cout << "# All times in milliseconds (msec) per operation" << endl;
+  cout << "# Column 1 = input data size" << endl;
+  cout << "# Column 2 = int insert front" << endl;
+  cout << "# Column 3 = int insert middle" << endl;
+  cout << "# Column 4 = int erase front" << endl;
+  cout << "# Column 5 = int erase middle" << endl;
+  cout << "# Column 6 = pair<int,int> insert front" << endl;
+  cout << "# Column 7 = pair<int,int> insert middle" << endl;
+  cout << "# Column 8 = pair<int,int> erase front" << endl;
+  cout << "# Column 9 = pair<int,int> erase middle" << endl;
+
+  const int shift_start = 1000000;
+  const int shift_step = 1000000;
+  const int shift_stop = 8000000;
+
+  ArraySeq<int> s1;
+  ArraySeq<pair<int,int>> s2;
+  s1.reserve(shift_stop + runs);
+  s2.reserve(shift_stop + runs);
+  for (int n = shift_start; n <= shift_stop; n += shift_step) {
+    // grow both sequences to n elements
+    while (s1.size() < n) {
+      s1.insert(s1.size(), s1.size());
+      s2.insert({s2.size(), s2.size()}, s2.size());
+    }
+
+    double c2 = timed_seq_insert(s1, 0, -1);
+    double c4 = timed_seq_erase(s1, 0);
+    double c3 = timed_seq_insert(s1, n / 2, -1);
+    double c5 = timed_seq_erase(s1, n / 2);
+    double c6 = timed_seq_insert(s2, 0, {-1, -1});
+    double c8 = timed_seq_erase(s2, 0);
+    double c7 = timed_seq_insert(s2, n / 2, {-1, -1});
+    double c9 = timed_seq_erase(s2, n / 2);
+
+    assert(s1.size() == n);
+    assert(s2.size() == n);
+
+    cout << n
+         << " " << c2 << " " << c3 << " " << c4 << " " << c5
+         << " " << c6 << " " << c7 << " " << c8 << " " << c9
+         << endl;
+  }
+}
+
+template<typename T>
+double timed_seq_insert(ArraySeq<T>& s, int index, const T& elem)
+{
+  double total = 0;
+  for (int r = 0; r < runs; ++r) {
+    auto t0 = high_resolution_clock::now();
+    s.insert(elem, index);
+    auto t1 = high_resolution_clock::now();
+    total += duration_cast<microseconds>(t1 - t0).count();
+  }
+  return (total/1000) / runs;
+}
+
+// removes the elements inserted by timed_seq_insert
+template<typename T>
+double timed_seq_erase(ArraySeq<T>& s, int index)
+{
+  double total = 0;
+  for (int r = 0; r < runs; ++r) {
+    auto t0 = high_resolution_clock::now();
+    s.erase(index);
+    auto t1 = high_resolution_clock::now();
+    total += duration_cast<microseconds>(t1 - t0).count();
+  }
+  return (total/1000) / runs;
+}
+
+//----------------------------------------------------------------------
+// ArraySeq sorting: sort (introsort), merge_sort and quick_sort on
+// ordered, reversed, and faro-shuffled data
+//----------------------------------------------------------------------
+void sort_perf()
+{
+  cout << "# All times in milliseconds (msec)" << endl;
+  cout << "# Column 1 = input data size" << endl;
+  cout << "# Column 2 = sort ordered" << endl;
+  cout << "# Column 3 = sort reversed" << endl;
+  cout << "# Column 4 = sort shuffled" << endl;
+  cout << "# Column 5 = merge sort ordered" << endl;
+  cout << "# Column 6 = merge sort reversed" << endl;
+  cout << "# Column 7 = merge sort shuffled" << endl;
+  cout << "# Column 8 = quick sort ordered" << endl;
+  cout << "# Column 9 = quick sort reversed" << endl;
+  cout << "# Column 10 = quick sort shuffled" << endl;
+
+  const int sort_start = 100000;
+  const int sort_step = 100000;
+  const int sort_stop = 1000000;
+
+  auto ordered = [](Sequence<int>& s) { reset_ordered(s); };
+  auto reversed = [](Sequence<int>& s) { reset_reversed(s); };
+  auto shuffled = [](Sequence<int>& s) { reset_ordered(s); reset_shuffled(s, 3); };
+  auto intro = [](ArraySeq<int>& s) { s.sort(); };
+  auto merge = [](ArraySeq<int>& s) { s.merge_sort(); };
+  auto quick = [](ArraySeq<int>& s) { s.quick_sort(); };
+
+  for (int n = sort_start; n <= sort_stop; n += sort_step) {
+    ArraySeq<int> s;
+    load_in_order(s, n);
+    cout << n
+         << " " << timed_sort(s, intro, ordered)
+         << " " << timed_sort(s, intro, reversed)
+         << " " << timed_sort(s, intro, shuffled)
+         << " " << timed_sort(s, merge, ordered)
+         << " " << timed_sort(s, merge, reversed)
+         << " " << timed_sort(s, merge, shuffled)
+         << " " << timed_sort(s, quick, ordered)
+         << " " << timed_sort(s, quick, reversed)
+         << " " << timed_sort(s, quick, shuffled)
+         << endl;
+  }
+}
+
+// resets the data before each run, only the sort itself is timed
+double timed_sort(ArraySeq<int>& s, function<void(ArraySeq<int>&)> sort_fn,
+                  function<void(Sequence<int>&)> reset)
+{
+  double total = 0;
+  for (int r = 0; r < runs; ++r) {
+    reset(s);
+    auto t0 = high_resolution_clock::now();
+    sort_fn(s);
+    auto t1 = high_resolution_clock::now();
+    total += duration_cast<microseconds>(t1 - t0).count();
+    for (int i = 1; i < s.size(); ++i)
+      assert(!(s[i] < s[i-1]));
+  }
+  return (total/1000) / runs;
+}
+
+//----------------------------------------------------------------------
+// Parallel merge sort scaling: sorts the same shuffled data with an
+// increasing number of threads (powers of two up to the core count)
+//----------------------------------------------------------------------
+void threads_perf()
+{
+  const int n = 4000000;
+  int cores = max(1, (int) thread::hardware_concurrency());
+
+  ArraySeq<int> s;
+  load_in_order(s, n);
+  auto shuffled = [](Sequence<int>& s) { reset_ordered(s); reset_shuffled(s, 3); };
+  double base = timed_sort(s, [](ArraySeq<int>& s) { s.merge_sort(); }, shuffled);
+
+  cout << "# " << n << " shuffled ints, " << cores << " hardware cores" << endl;
+  cout << "# Sequential merge sort = " << base << " msec" << endl;
+  cout << "# Column 1 = threads" << endl;
+  cout << "# Column 2 = parallel merge sort time (msec)" << endl;
+  cout << "# Column 3 = speedup versus sequential merge sort" << endl;
+
+  for (int t = 1; ; t = min(t * 2, cores)) {
+    double c2 = timed_sort(s, [t](ArraySeq<int>& s) { s.parallel_merge_sort(t); },
+                           shuffled);
+    cout << t << " " << c2 << " " << (c2 > 0 ? base / c2 : 0) << endl;
+    if (t == cores)
+      break;
+  }
+}
+
+//----------------------------------------------------------------------
+// Radix sorting: sort() on int and pair<int,int> (radix sorted) versus
+// the comparison sorts on shuffled data
+//----------------------------------------------------------------------
+void radix_perf()
+{
+  cout << "# All times in milliseconds (msec)" << endl;
+  cout << "# Column 1 = input data size" << endl;
+  cout << "# Column 2 = int sort (radix)" << endl;
+  cout << "# Column 3 = int quick sort" << endl;
+  cout << "# Column 4 = int merge sort" << endl;
+  cout << "# Column 5 = pair<int,int> sort (radix)" << endl;
+  cout << "# Column 6 = pair<int,int> merge sort" << endl;
+
+  const int radix_start = 1000000;
+  const int radix_step = 1000000;
+  const int radix_stop = 10000000;
+
+  auto shuffled = [](Sequence<int>& s) { reset_ordered(s); reset_shuffled(s, 3); };
+
+  for (int n = radix_start; n <= radix_stop; n += radix_step) {
+    ArraySeq<int> s;
+    load_in_order(s, n);
+    double c2 = timed_sort(s, [](ArraySeq<int>& s) { s.sort(); }, shuffled);
+    double c3 = timed_sort(s, [](ArraySeq<int>& s) { s.quick_sort(); }, shuffled);
+    double c4 = timed_sort(s, [](ArraySeq<int>& s) { s.merge_sort(); }, shuffled);
+
+    // pairs keyed on the same shuffled values
+    shuffled(s);
+    ArraySeq<pair<int,int>> p;
+    p.reserve(n);
+    for (int i = 0; i < n; ++i)
+      p.insert({s[i], i}, i);
+    ArraySeq<pair<int,int>> q = p;
+    auto t0 = high_resolution_clock::now();
+    p.sort();
+    auto t1 = high_resolution_clock::now();
+    q.merge_sort();
+    auto t2 = high_resolution_clock::now();
+    double c5 = duration_cast<microseconds>(t1 - t0).count() / 1000.0;
+    double c6 = duration_cast<microseconds>(t2 - t1).count() / 1000.0;
+
+    cout << n << " " << c2 << " " << c3 << " " << c4
+         << " " << c5 << " " << c6 << endl;
+  }
+}
+
+//----------------------------------------------------------------------
+// Dispatch: the same contains() batch called through a Map<int,int>&
+// (virtual) and through the concrete (final) map type (static)
+//----------------------------------------------------------------------
+void dispatch_perf()
+{
+  cout << "# All times in milliseconds (msec) for " << lookups << " contains" << endl;
+  cout << "# Column 1 = input data size" << endl;
+  cout << "# Column 2 = binsearch map virtual" << endl;
+  cout << "# Column 3 = binsearch map static" << endl;
+  cout << "# Column 4 = array map virtual" << endl;
+  cout << "# Column 5 = array map static" << endl;
+
+  ArraySeq<int> keys;
+  keys.reserve(stop);
+  for (int i = 2; i <= stop*2; i += 2)
+    keys.insert(i, keys.size());
+  faro_shuffle(keys, 3);
+
+  for (int n = start + step; n <= stop; n += step) {
+    BinSearchMap<int,int> m1;
+    ArrayMap<int,int> m2;
+    for (int i = 0; i < n; ++i) {
+      m1.insert(keys[i], i);
+      m2.insert(keys[i], i);
+    }
+    static_assert(is_map<BinSearchMap<int,int>, int, int>::value, "");
+    static_assert(is_map<ArrayMap<int,int>, int, int>::value, "");
+
+    double c2 = timed_contains_batch<Map<int,int>>(m1, keys, n);
+    double c3 = timed_contains_batch(m1, keys, n);
+    double c4 = timed_contains_batch<Map<int,int>>(m2, keys, n);
+    double c5 = timed_contains_batch(m2, keys, n);
+    cout << n << " " << c2 << " " << c3 << " " << c4 << " " << c5 << endl;
+  }
+}
+
+// calls contains through the static type M: a concrete final map
+// binds the calls statically, Map<int,int> dispatches them virtually
+template<typename M>
+double timed_contains_batch(const M& m, const ArraySeq<int>& keys, int n)
+{
+  double total = 0;
+  int found = 0;
+  for (int r = 0; r < runs; ++r) {
+    auto t0 = high_resolution_clock::now();
+    for (int i = 0; i < lookups; ++i)
+      found += m.contains(keys.at_unchecked((i * 7919) % n));
+    auto t1 = high_resolution_clock::now();
+    total += duration_cast<microseconds>(t1 - t0).count();
+  }
+  assert(found == runs * lookups);
+  return (total/1000) / runs;
+}
+
+
+//----------------------------------------------------------------------
+// Strings: loading maps with string values by copying (insert of an
+// lvalue), moving (insert of an rvalue), and constructing in place
+// (try_emplace)
+//----------------------------------------------------------------------
+void strings_perf()
+{
+  static const int len = 64;
+  cout << "# All times in milliseconds (msec) to load n values of " << len
+       << " chars" << endl;
+  cout << "# Column 1 = input data size" << endl;
+  cout << "# Column 2 = binsearch map copy insert" << endl;
+  cout << "# Column 3 = binsearch map move insert" << endl;
+  cout << "# Column 4 = binsearch map try_emplace" << endl;
+  cout << "# Column 5 = array map copy insert" << endl;
+  cout << "# Column 6 = array map move insert" << endl;
+  cout << "# Column 7 = array map try_emplace" << endl;
+
+  ArraySeq<int> keys;
+  keys.reserve(stop);
+  for (int i = 0; i < stop; ++i)
+    keys.insert(i, keys.size());
+  faro_shuffle(keys, 3);
+
+  using BinMap = BinSearchMap<int,string>;
+  using ArrMap = ArrayMap<int,string>;
+  for (int n = start + step; n <= stop; n += step) {
+    cout << n;
+    cout << " " << timed_string_load<BinMap>(keys, n, [](BinMap& m, int k) {
+        string v(len, 'x'); m.insert(k, v); });
+    cout << " " << timed_string_load<BinMap>(keys, n, [](BinMap& m, int k) {
+        string v(len, 'x'); m.insert(int(k), std::move(v)); });
+    cout << " " << timed_string_load<BinMap>(keys, n, [](BinMap& m, int k) {
+        m.try_emplace(k, len, 'x'); });
+    cout << " " << timed_string_load<ArrMap>(keys, n, [](ArrMap& m, int k) {
+        string v(len, 'x'); m.insert(k, v); });
+    cout << " " << timed_string_load<ArrMap>(keys, n, [](ArrMap& m, int k) {
+        string v(len, 'x'); m.insert(int(k), std::move(v)); });
+    cout << " " << timed_string_load<ArrMap>(keys, n, [](ArrMap& m, int k) {
+        m.try_emplace(k, len, 'x'); });
+    cout << endl;
+  }
+}
+
+// loads the first n keys into a new map using the add function
+template<typename M>
+double timed_string_load(const ArraySeq<int>& keys, int n,
+                         function<void(M&, int)> add)
+{
+  double total = 0;
+  for (int r = 0; r < runs; ++r) {
+    M m;
+    auto t0 = high_resolution_clock::now();
+    for (int i = 0; i < n; ++i)
+      add(m, keys.at_unchecked(i));
+    auto t1 = high_resolution_clock::now();
+    total += duration_cast<microseconds>(t1 - t0).count();
+    assert(m.size() == n);
+  }
+  return (total/1000) / runs;
+}
+
+
+//----------------------------------------------------------------------
+// Views: BinSearchMap range and sorted key results returned as copied
+// ArraySeqs versus as KeyViews over the pairs
+//----------------------------------------------------------------------
+void views_perf()
+{
+  cout << "# All times in milliseconds (msec) for " << lookups << " calls" << endl;
+  cout << "# Column 1 = input data size" << endl;
+  cout << "# Column 2 = find_keys (10% of keys)" << endl;
+  cout << "# Column 3 = find_keys_view (10% of keys)" << endl;
+  cout << "# Column 4 = sorted_keys" << endl;
+  cout << "# Column 5 = sorted_keys_view" << endl;
+
+  ArraySeq<int> keys;
+  keys.reserve(stop);
+  for (int i = 0; i < stop; ++i)
+    keys.insert(i, keys.size());
+  faro_shuffle(keys, 3);
+
+  for (int n = start + step; n <= stop; n += step) {
+    BinSearchMap<int,int> m;
+    for (int i = 0; i < n; ++i)
+      m.insert(keys[i], i);
+    // touch every key so the views are not cheaper only because they
+    // are never read
+    auto time_calls = [&](function<long(int)> call) {
+      long sum = 0;
+      auto t0 = high_resolution_clock::now();
+      for (int i = 0; i < lookups; ++i)
+        sum += call(keys.at_unchecked(i % n));
+      auto t1 = high_resolution_clock::now();
+      assert(sum >= 0);
+      return duration_cast<microseconds>(t1 - t0).count() / 1000.0;
+    };
+    auto sum_seq = [](const ArraySeq<int>& s) {
+      long sum = 0;
+      for (int k : s)
+        sum += k;
+      return sum;
+    };
+    auto sum_view = [](const KeyView<int>& v) {
+      long sum = 0;
+      for (int k : v)
+        sum += k;
+      return sum;
+    };
+    int width = n / 10;
+    cout << n;
+    cout << " " << time_calls([&](int k) {
+        return sum_seq(m.find_keys(k, k + width)); });
+    cout << " " << time_calls([&](int k) {
+        return sum_view(m.find_keys_view(k, k + width)); });
+    cout << " " << time_calls([&](int) {
+        return sum_seq(m.sorted_keys()); });
+    cout << " " << time_calls([&](int) {
+        return sum_view(m.sorted_keys_view()); });
+    cout << endl;
+  }
+}
+
+//----------------------------------------------------------------------
+// Linked: LinkedSeq with pooled nodes (NodePool) versus one new per
+// node (HeapNodes). Each run builds a list of n elements at alternating
+// ends, erases half of them, adds as many back, then traverses it.
+//----------------------------------------------------------------------
+void linked_perf()
+{
+  const int big_step = 100000;
+  cout << "# All times in milliseconds (msec)" << endl;
+  cout << "# Column 1 = input data size" << endl;
+  cout << "# Column 2 = pooled nodes insert + erase" << endl;
+  cout << "# Column 3 = new-per-node insert + erase" << endl;
+  cout << "# Column 4 = pooled nodes traversal" << endl;
+  cout << "# Column 5 = new-per-node traversal" << endl;
+
+  for (int n = big_step; n <= 10 * big_step; n += big_step) {
+    long t1 = 0;
+    long t2 = 0;
+    double c2 = timed_linked_churn<LinkedSeq<int>>(n, t1);
+    double c3 = timed_linked_churn<LinkedSeq<int, HeapNodes>>(n, t2);
+    cout << n << " " << c2 << " " << c3 << " "
+         << t1 / 1000.0 / runs << " " << t2 / 1000.0 / runs << endl;
+  }
+}
+
+// builds and churns a sequence of n elements, returning the time for
+// that in msec and setting traversal to the total traversal time (in
+// usec) over all runs
+template<typename S>
+double timed_linked_churn(int n, long& traversal)
+{
+  double total = 0;
+  traversal = 0;
+  for (int r = 0; r < runs; ++r) {
+    S s;
+    long expected = 0;
+    auto t0 = high_resolution_clock::now();
+    // adding at alternating ends (and reusing erased nodes) means list
+    // order stops matching allocation order
+    for (int i = 0; i < n; ++i) {
+      s.insert(i, i % 2 == 0 ? s.size() : 0);
+      expected += i;
+    }
+    for (int i = 0; i < n / 2; ++i) {
+      expected -= s[0];
+      s.erase(0);
+    }
+    for (int i = 0; i < n / 2; ++i) {
+      s.insert(i, i % 2 == 0 ? s.size() : 0);
+      expected += i;
+    }
+    auto t1 = high_resolution_clock::now();
+    long check = 0;
+    for (int x : s)
+      check += x;
+    auto t2 = high_resolution_clock::now();
+    assert(check == expected);
+    total += duration_cast<microseconds>(t1 - t0).count();
+    traversal += duration_cast<microseconds>(t2 - t1).count();
+  }
+  return (total/1000) / runs;
+}
+
+//----------------------------------------------------------------------
+// Middle: inserting every element at the middle of the sequence, then
+// scanning it, for ArraySeq, LinkedSeq and UnrolledSeq
+//----------------------------------------------------------------------
+void middle_perf()
+{
+  cout << "# All times in milliseconds (msec)" << endl;
+  cout << "# Column 1 = input data size" << endl;
+  cout << "# Column 2 = array seq middle inserts" << endl;
+  cout << "# Column 3 = linked seq middle inserts" << endl;
+  cout << "# Column 4 = unrolled seq middle inserts" << endl;
+  cout << "# Column 5 = array seq scan (x100)" << endl;
+  cout << "# Column 6 = linked seq scan (x100)" << endl;
+  cout << "# Column 7 = unrolled seq scan (x100)" << endl;
 
+  for (int n = start + step; n <= stop; n += step) {
+    double s1 = 0, s2 = 0, s3 = 0;
+    double c2 = timed_middle_inserts<ArraySeq<int>>(n, s1);
+    double c3 = timed_middle_inserts<LinkedSeq<int>>(n, s2);
+    double c4 = timed_middle_inserts<UnrolledSeq<int>>(n, s3);
+    cout << n << " " << c2 << " " << c3 << " " << c4 << " "
+         << s1 << " " << s2 << " " << s3 << endl;
+  }
+}
 
+// inserts n elements one at a time at the middle of a new sequence,
+// returning the time in msec and setting scan to the time (in msec)
+// of 100 scans over the result
+template<typename S>
+double timed_middle_inserts(int n, double& scan)
+{
+  double total = 0;
+  double scan_total = 0;
+  for (int r = 0; r < runs; ++r) {
+    S s;
+    auto t0 = high_resolution_clock::now();
+    for (int i = 0; i < n; ++i)
+      s.insert(i, s.size() / 2);
+    auto t1 = high_resolution_clock::now();
+    long sum = 0;
+    for (int j = 0; j < 100; ++j)
+      for (int x : s)
+        sum += x;
+    auto t2 = high_resolution_clock::now();
+    assert(sum == 100L * n * (n - 1) / 2);
+    total += duration_cast<microseconds>(t1 - t0).count();
+    scan_total += duration_cast<microseconds>(t2 - t1).count();
+  }
+  scan = (scan_total/1000) / runs;
+  return (total/1000) / runs;
+}
+
+//----------------------------------------------------------------------
+// Tiered: BinSearchMap backed by ArraySeq versus TieredSeq, loading n
+// shuffled keys (so most inserts land in the middle) and then looking
+// up keys. Each size is run once.
+//----------------------------------------------------------------------
+void tiered_perf()
+{
+  const int big_step = 20000;
+  cout << "# All times in milliseconds (msec)" << endl;
+  cout << "# Column 1 = input data size" << endl;
+  cout << "# Column 2 = array backed map load" << endl;
+  cout << "# Column 3 = tiered backed map load" << endl;
+  cout << "# Column 4 = array backed map " << lookups << " lookups" << endl;
+  cout << "# Column 5 = tiered backed map " << lookups << " lookups" << endl;
+
+  ArraySeq<int> keys;
+  keys.reserve(10 * big_step);
+  for (int i = 0; i < 10 * big_step; ++i)
+    keys.insert(i, keys.size());
+  faro_shuffle(keys, 3);
+
+  for (int n = big_step; n <= 10 * big_step; n += big_step) {
+    BinSearchMap<int,int> m1;
+    BinSearchMap<int,int,TieredSeq> m2;
+    auto t0 = high_resolution_clock::now();
+    for (int i = 0; i < n; ++i)
+      m1.insert(keys[i], i);
+    auto t1 = high_resolution_clock::now();
+    for (int i = 0; i < n; ++i)
+      m2.insert(keys[i], i);
+    auto t2 = high_resolution_clock::now();
+    double c2 = duration_cast<microseconds>(t1 - t0).count() / 1000.0;
+    double c3 = duration_cast<microseconds>(t2 - t1).count() / 1000.0;
+    cout << n << " " << c2 << " " << c3 << " "
+         << timed_contains_batch(m1, keys, n) << " "
+         << timed_contains_batch(m2, keys, n) << endl;
+  }
+}
+
+//----------------------------------------------------------------------
+// Gap: BinSearchMap backed by ArraySeq versus GapSeq, loading n keys
+// either clustered (runs of 64 consecutive keys, runs in shuffled
+// order) or fully shuffled. Each size is run once.
+//----------------------------------------------------------------------
+void gap_perf()
+{
+  const int big_step = 20000;
+  const int run = 64;
+  cout << "# All times in milliseconds (msec)" << endl;
+  cout << "# Column 1 = input data size" << endl;
+  cout << "# Column 2 = array backed map clustered load" << endl;
+  cout << "# Column 3 = gap backed map clustered load" << endl;
+  cout << "# Column 4 = array backed map random load" << endl;
+  cout << "# Column 5 = gap backed map random load" << endl;
 
+  for (int n = big_step; n <= 10 * big_step; n += big_step) {
+    ArraySeq<int> runs_order;
+    for (int r = 0; r < n / run; ++r)
+      runs_order.insert(r, runs_order.size());
+    faro_shuffle(runs_order, 3);
+    ArraySeq<int> clustered;
+    clustered.reserve(n);
+    for (int r : runs_order)
+      for (int j = 0; j < run; ++j)
+        clustered.insert(r * run + j, clustered.size());
+    ArraySeq<int> shuffled = clustered;
+    faro_shuffle(shuffled, 3);
+
+    cout << n;
+    for (const ArraySeq<int>* keys : {&clustered, &shuffled}) {
+      BinSearchMap<int,int> m1;
+      BinSearchMap<int,int,GapSeq> m2;
+      auto t0 = high_resolution_clock::now();
+      for (int k : *keys)
+        m1.insert(k, k);
+      auto t1 = high_resolution_clock::now();
+      for (int k : *keys)
+        m2.insert(k, k);
+      auto t2 = high_resolution_clock::now();
+      assert(m1.size() == m2.size());
+      cout << " " << duration_cast<microseconds>(t1 - t0).count() / 1000.0
+           << " " << duration_cast<microseconds>(t2 - t1).count() / 1000.0;
+    }
+    cout << endl;
+  }
+}
+
+//----------------------------------------------------------------------
+// Ring: BinSearchMap backed by ArraySeq versus RingSeq, loading n keys
+// in descending order (every insert is at the front, the min - 1 case)
+// or shuffled. Each size is run once.
+//----------------------------------------------------------------------
+void ring_perf()
+{
+  const int big_step = 20000;
+  cout << "# All times in milliseconds (msec)" << endl;
+  cout << "# Column 1 = input data size" << endl;
+  cout << "# Column 2 = array backed map descending load" << endl;
+  cout << "# Column 3 = ring backed map descending load" << endl;
+  cout << "# Column 4 = array backed map random load" << endl;
+  cout << "# Column 5 = ring backed map random load" << endl;
+
+  for (int n = big_step; n <= 10 * big_step; n += big_step) {
+    ArraySeq<int> descending;
+    descending.reserve(n);
+    for (int i = n; i > 0; --i)
+      descending.insert(i, descending.size());
+    ArraySeq<int> shuffled = descending;
+    faro_shuffle(shuffled, 3);
+
+    cout << n;
+    for (const ArraySeq<int>* keys : {&descending, &shuffled}) {
+      BinSearchMap<int,int> m1;
+      BinSearchMap<int,int,RingSeq> m2;
+      auto t0 = high_resolution_clock::now();
+      for (int k : *keys)
+        m1.insert(k, k);
+      auto t1 = high_resolution_clock::now();
+      for (int k : *keys)
+        m2.insert(k, k);
+      auto t2 = high_resolution_clock::now();
+      assert(m1.size() == m2.size());
+      cout << " " << duration_cast<microseconds>(t1 - t0).count() / 1000.0
+           << " " << duration_cast<microseconds>(t2 - t1).count() / 1000.0;
+    }
+    cout << endl;
+  }
+}
+
+//----------------------------------------------------------------------
+// Layout: BinSearchMap with pairs stored together (PairLayout) versus
+// keys and values in separate arrays (SplitLayout), for int values and
+// for 64 byte values. Keys are loaded in order (appends), then 1M
+// random keys are looked up, reading each value found.
+//----------------------------------------------------------------------
+
+// a value type that fills a 64 byte cache line (compared by id, since
+// the sequences holding it need < and ==)
+struct Payload64
+{
+  int id;
+  char bytes[60];
+};
+
+bool operator<(const Payload64& lhs, const Payload64& rhs)
+{
+  return lhs.id < rhs.id;
+}
+
+bool operator==(const Payload64& lhs, const Payload64& rhs)
+{
+  return lhs.id == rhs.id;
+}
+
+void layout_perf()
+{
+  const int probes = 1000000;
+  cout << "# All times in milliseconds (msec)" << endl;
+  cout << "# Column 1 = input data size" << endl;
+  cout << "# Column 2 = int values, pair layout" << endl;
+  cout << "# Column 3 = int values, split layout" << endl;
+  cout << "# Column 4 = 64 byte values, pair layout" << endl;
+  cout << "# Column 5 = 64 byte values, split layout" << endl;
+
+  // looks up the probe keys, summing part of each value so the value
+  // reads are not optimized away
+  auto lookup = [probes](const auto& m, const ArraySeq<int>& keys, int n,
+                         auto value_id) {
+    long sum = 0;
+    auto t0 = high_resolution_clock::now();
+    for (int i = 0; i < probes; ++i)
+      sum += value_id(m[keys.at_unchecked((i * 7919L) % n)]);
+    auto t1 = high_resolution_clock::now();
+    assert(sum > 0);
+    return duration_cast<microseconds>(t1 - t0).count() / 1000.0;
+  };
+  auto int_id = [](int v) { return v; };
+  auto payload_id = [](const Payload64& v) { return v.id; };
+
+  for (int n = 1 << 14; n <= 1 << 21; n *= 2) {
+    ArraySeq<int> keys;
+    keys.reserve(n);
+    for (int i = 0; i < n; ++i)
+      keys.insert(2 * i + 1, i);
+    faro_shuffle(keys, 3);
+
+    cout << n;
+    {
+      BinSearchMap<int,int> m1;
+      BinSearchMap<int,int,ArraySeq,SplitLayout> m2;
+      for (int i = 0; i < n; ++i) {
+        m1.insert(2 * i + 1, i + 1);
+        m2.insert(2 * i + 1, i + 1);
+      }
+      cout << " " << lookup(m1, keys, n, int_id)
+           << " " << lookup(m2, keys, n, int_id);
+    }
+    {
+      BinSearchMap<int,Payload64> m1;
+      BinSearchMap<int,Payload64,ArraySeq,SplitLayout> m2;
+      for (int i = 0; i < n; ++i) {
+        m1.insert(2 * i + 1, Payload64{i + 1, {}});
+        m2.insert(2 * i + 1, Payload64{i + 1, {}});
+      }
+      cout << " " << lookup(m1, keys, n, payload_id)
+           << " " << lookup(m2, keys, n, payload_id);
+    }
+    cout << endl;
+  }
+}
+
+//----------------------------------------------------------------------
+// Static: lookup latency of BinSearchMap versus StaticMap (Eytzinger
+// layout) from 1K to 100M int keys. Both maps are built from the same
+// sorted keys, then 1M present keys in pseudorandom order are looked
+// up in each. Times are average nanoseconds per lookup.
+//----------------------------------------------------------------------
+void static_perf()
+{
+  const int probes = 1000000;
+  cout << "# All times in nanoseconds (nsec) per lookup" << endl;
+  cout << "# Column 1 = number of keys" << endl;
+  cout << "# Column 2 = BinSearchMap lookup" << endl;
+  cout << "# Column 3 = StaticMap lookup" << endl;
+
+  // looks up probe keys 2r + 1 for pseudorandom ranks r
+  auto lookup = [probes](const auto& m, int n) {
+    unsigned r = 12345;
+    long found = 0;
+    auto t0 = high_resolution_clock::now();
+    for (int i = 0; i < probes; ++i) {
+      r = r * 1664525 + 1013904223;
+      found += m.contains(2 * int(r % n) + 1);
+    }
+    auto t1 = high_resolution_clock::now();
+    assert(found == probes);
+    return duration_cast<nanoseconds>(t1 - t0).count() / double(probes);
+  };
+
+  for (long n = 1000; n <= 100000000; n *= 10) {
+    ArraySeq<int> keys;
+    ArraySeq<int> values;
+    keys.reserve(n);
+    values.reserve(n);
+    for (int i = 0; i < n; ++i) {
+      keys.insert(2 * i + 1, i);
+      values.insert(i, i);
+    }
+    double c2;
+    {
+      BinSearchMap<int,int> m1;
+      for (int i = 0; i < n; ++i)
+        m1.insert(keys[i], values[i]);
+      c2 = lookup(m1, n);
+    }
+    StaticMap<int,int> m2(std::move(keys), std::move(values));
+    cout << n << " " << c2 << " " << lookup(m2, n) << endl;
+  }
+}
+
+//----------------------------------------------------------------------
+// BTree: BTreeMap versus BinSearchMap at 1M to 100M int keys. Both
+// are loaded with the even keys 0 .. 2n - 2 (the B+tree by bulk
+// load), then random odd keys are inserted and erased again, and
+// random present keys are looked up. Times other than the bulk load
+// are average nanoseconds per operation; BinSearchMap inserts and
+// erases shift O(n) pairs, so only 100 of each are timed.
+//----------------------------------------------------------------------
+void btree_perf()
+{
+  const int btree_ops = 1000000;
+  const int binsearch_ops = 100;
+  cout << "# Column 1 = number of keys" << endl;
+  cout << "# Column 2 = BTreeMap bulk load (msec)" << endl;
+  cout << "# Column 3 = BTreeMap insert (nsec per op)" << endl;
+  cout << "# Column 4 = BTreeMap erase (nsec per op)" << endl;
+  cout << "# Column 5 = BTreeMap lookup (nsec per op)" << endl;
+  cout << "# Column 6 = BinSearchMap insert (nsec per op)" << endl;
+  cout << "# Column 7 = BinSearchMap erase (nsec per op)" << endl;
+  cout << "# Column 8 = BinSearchMap lookup (nsec per op)" << endl;
+
+  // times ops inserts of odd keys, erases of the same keys, and
+  // lookups of even keys, returning nanoseconds per operation
+  auto churn = [](auto& m, int n, int ops, double& insert_ns,
+                  double& erase_ns, double& lookup_ns) {
+    unsigned r = 12345;
+    ArraySeq<int> odd;
+    odd.reserve(ops);
+    for (int i = 0; i < ops; ++i) {
+      r = r * 1664525 + 1013904223;
+      odd.insert(2 * int(r % n) + 1, i);
+    }
+    auto t0 = high_resolution_clock::now();
+    for (int k : odd)
+      m.insert(k, k);
+    auto t1 = high_resolution_clock::now();
+    for (int k : odd)
+      if (m.contains(k))
+        m.erase(k);
+    auto t2 = high_resolution_clock::now();
+    long found = 0;
+    for (int k : odd)
+      found += m.contains(k - 1);
+    auto t3 = high_resolution_clock::now();
+    assert(m.size() == n and found == ops);
+    insert_ns = duration_cast<nanoseconds>(t1 - t0).count() / double(ops);
+    erase_ns = duration_cast<nanoseconds>(t2 - t1).count() / double(ops);
+    lookup_ns = duration_cast<nanoseconds>(t3 - t2).count() / double(ops);
+  };
+
+  for (int n = 1000000; n <= 100000000; n *= 10) {
+    ArraySeq<int> keys;
+    ArraySeq<int> values;
+    keys.reserve(n);
+    values.reserve(n);
+    for (int i = 0; i < n; ++i) {
+      keys.insert(2 * i, i);
+      values.insert(i, i);
+    }
+
+    double c6, c7, c8;
+    {
+      BinSearchMap<int,int> m;
+      for (int i = 0; i < n; ++i)
+        m.insert(keys[i], values[i]);
+      churn(m, n, binsearch_ops, c6, c7, c8);
+    }
+
+    auto t0 = high_resolution_clock::now();
+    BTreeMap<int,int> m(std::move(keys), std::move(values));
+    auto t1 = high_resolution_clock::now();
+    double c2 = duration_cast<microseconds>(t1 - t0).count() / 1000.0;
+    double c3, c4, c5;
+    churn(m, n, btree_ops, c3, c4, c5);
+    cout << n << " " << c2 << " " << c3 << " " << c4 << " " << c5
+         << " " << c6 << " " << c7 << " " << c8 << endl;
+  }
+}
+
+//----------------------------------------------------------------------
+// Tree: TreeMap (AVL) versus BTreeMap versus BinSearchMap on mixes of
+// lookups and writes at 1K to 1M int keys. Each map holds the even
+// keys 0 .. 2n - 2 (the trees loaded in shuffled order, BinSearchMap
+// in order so its load stays cheap). In a mix, the given percent of
+// operations are writes, alternately inserting a random odd key and
+// erasing it again, so the size stays near n; the rest look up random
+// even keys. Times are average nanoseconds per operation; BinSearchMap
+// writes shift O(n) pairs, so it runs fewer operations.
+//----------------------------------------------------------------------
+void tree_perf()
+{
+  const int tree_ops = 1000000;
+  const int binsearch_ops = 20000;
+  const int write_percents[] = {1, 10, 50};
+  cout << "# All times in nanoseconds per operation" << endl;
+  cout << "# Column 1 = number of keys" << endl;
+  int column = 2;
+  for (int w : write_percents) {
+    cout << "# Column " << column++ << " = TreeMap, " << w << "% writes" << endl;
+    cout << "# Column " << column++ << " = BTreeMap, " << w << "% writes" << endl;
+    cout << "# Column " << column++ << " = BinSearchMap, " << w << "% writes"
+         << endl;
+  }
+
+  // runs ops operations of the mix on the map, returning nanoseconds
+  // per operation
+  auto mix = [](auto& m, int n, int ops, int write_percent) {
+    unsigned r = 12345;
+    ArraySeq<int> keys;
+    ArraySeq<char> writes;
+    keys.reserve(ops);
+    writes.reserve(ops);
+    for (int i = 0; i < ops; ++i) {
+      r = r * 1664525 + 1013904223;
+      bool write = int(r % 100) < write_percent;
+      r = r * 1664525 + 1013904223;
+      writes.insert(write, i);
+      keys.insert(2 * int(r % n) + write, i);
+    }
+    int pending = -1;
+    long found = 0;
+    auto t0 = high_resolution_clock::now();
+    for (int i = 0; i < ops; ++i) {
+      if (!writes[i])
+        found += m.contains(keys[i]);
+      else if (pending < 0) {
+        pending = keys[i];
+        m.insert(pending, pending);
+      }
+      else {
+        m.erase(pending);
+        pending = -1;
+      }
+    }
+    auto t1 = high_resolution_clock::now();
+    assert(found > 0 and m.size() == n + (pending >= 0));
+    if (pending >= 0)
+      m.erase(pending);
+    return duration_cast<nanoseconds>(t1 - t0).count() / double(ops);
+  };
+
+  for (int n = 1000; n <= 1000000; n *= 10) {
+    ArraySeq<int> keys;
+    keys.reserve(n);
+    for (int i = 0; i < n; ++i)
+      keys.insert(2 * i, i);
+    BinSearchMap<int,int> m3;
+    for (int k : keys)
+      m3.insert(k, k);
+    faro_shuffle(keys, 3);
+    TreeMap<int,int> m1;
+    BTreeMap<int,int> m2;
+    for (int k : keys) {
+      m1.insert(k, k);
+      m2.insert(k, k);
+    }
+    cout << n;
+    for (int w : write_percents)
+      cout << " " << mix(m1, n, tree_ops, w) << " " << mix(m2, n, tree_ops, w)
+           << " " << mix(m3, n, binsearch_ops, w);
+    cout << endl;
+  }
+}
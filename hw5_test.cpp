@@ -5,13 +5,24 @@
 // DESC: 
 //---------------------------------------------------------------------------
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <gtest/gtest.h>
 #include "arrayseq.h"
+#include "linkedseq.h"
+#include "unrolledseq.h"
+#include "tieredseq.h"
+#include "gapseq.h"
+#include "ringseq.h"
 #include "arraymap.h"
 #include "linkedmap.h"
 #include "binsearchmap.h"
+#include "unrolledmap.h"
+#include "staticmap.h"
+#include "hashmap.h"
+#include "btreemap.h"
+#include "treemap.h"
 
 using namespace std;
 
@@ -156,6 +167,21 @@ TEST(BasicArrayMapTests, InvalidKeyCheck)
   EXPECT_THROW(m.erase('b'), std::out_of_range);
 }
 
+TEST(BasicArrayMapTests, TryEmplaceCheck)
+{
+  ArrayMap<int,string> m;
+  string v = "twenty";
+  m.insert(20, std::move(v));
+  ASSERT_EQ(true, v.empty());
+  ASSERT_EQ(true, m.try_emplace(10, 3, 'x'));
+  ASSERT_EQ(false, m.try_emplace(20, "other"));
+  ASSERT_EQ(true, m.try_emplace(30, "thirty"));
+  ASSERT_EQ(3, m.size());
+  ASSERT_EQ("xxx", m[10]);
+  ASSERT_EQ("twenty", m[20]);
+  ASSERT_EQ("thirty", m[30]);
+}
+
 
 //----------------------------------------------------------------------
 // Basic Tests for the LinkedSeq implementation of Map
@@ -297,6 +323,21 @@ TEST(BasicLinkedMapTests, InvalidKeyCheck)
   EXPECT_THROW(m.erase('b'), std::out_of_range);
 }
 
+TEST(BasicLinkedMapTests, TryEmplaceCheck)
+{
+  LinkedMap<int,string> m;
+  string v = "twenty";
+  m.insert(20, std::move(v));
+  ASSERT_EQ(true, v.empty());
+  ASSERT_EQ(true, m.try_emplace(10, 3, 'x'));
+  ASSERT_EQ(false, m.try_emplace(20, "other"));
+  ASSERT_EQ(true, m.try_emplace(30, "thirty"));
+  ASSERT_EQ(3, m.size());
+  ASSERT_EQ("xxx", m[10]);
+  ASSERT_EQ("twenty", m[20]);
+  ASSERT_EQ("thirty", m[30]);
+}
+
 
 //----------------------------------------------------------------------
 // Basic Tests for the Binary Search implementation of Map
@@ -438,6 +479,1730 @@ TEST(BasicBinSearchMapTests, InvalidKeyCheck)
   EXPECT_THROW(m.erase('b'), std::out_of_range);
 }
 
+TEST(BasicBinSearchMapTests, KeyViewCheck)
+{
+  BinSearchMap<int,string> m;
+  ASSERT_EQ(0, m.sorted_keys_view().size());
+  for (int k : {50, 10, 40, 20, 30})
+    m.insert(k, "v");
+  KeyView<int> all = m.sorted_keys_view();
+  ASSERT_EQ(5, all.size());
+  ASSERT_EQ(10, all[0]);
+  ASSERT_EQ(50, all[4]);
+  EXPECT_THROW(all[5], std::out_of_range);
+  ASSERT_EQ(30, *(2 + all.begin()));
+  KeyView<int> mid = m.find_keys_view(15, 40);
+  ASSERT_EQ(3, mid.size());
+  int expected = 20;
+  for (int k : mid) {
+    ASSERT_EQ(expected, k);
+    expected += 10;
+  }
+  ASSERT_EQ(true, m.find_keys_view(41, 49).empty());
+  ArraySeq<int> copy = mid.to_seq();
+  m.erase(30);
+  ASSERT_EQ(3, copy.size());
+  ASSERT_EQ(30, copy[1]);
+}
+
+TEST(BasicBinSearchMapTests, TryEmplaceCheck)
+{
+  BinSearchMap<int,string> m;
+  string v = "twenty";
+  m.insert(20, std::move(v));
+  ASSERT_EQ(true, v.empty());
+  ASSERT_EQ(true, m.try_emplace(10, 3, 'x'));
+  ASSERT_EQ(false, m.try_emplace(20, "other"));
+  ASSERT_EQ(true, m.try_emplace(30, "thirty"));
+  ASSERT_EQ(3, m.size());
+  ASSERT_EQ("xxx", m[10]);
+  ASSERT_EQ("twenty", m[20]);
+  ASSERT_EQ("thirty", m[30]);
+}
+
+
+TEST(BasicBinSearchMapTests, SplitLayoutCheck)
+{
+  BinSearchMap<int,string,ArraySeq,SplitLayout> m;
+  ASSERT_EQ(0, m.sorted_keys().size());
+  for (int k : {50, 10, 40, 20, 30})
+    m.insert(k, to_string(k));
+  ASSERT_EQ(true, m.try_emplace(60, 2, 'x'));
+  ASSERT_EQ(false, m.try_emplace(10, "other"));
+  ASSERT_EQ("xx", m[60]);
+  m[10] = "ten";
+  ASSERT_EQ("ten", m[10]);
+  m.erase(40);
+  EXPECT_THROW(m[40], std::out_of_range);
+  ASSERT_EQ(5, m.size());
+  ArraySeq<int> keys = m.sorted_keys();
+  ASSERT_EQ(10, keys[0]);
+  ASSERT_EQ(60, keys[4]);
+  KeyView<int> mid = m.find_keys_view(15, 50);
+  ASSERT_EQ(3, mid.size());
+  ASSERT_EQ(20, mid[0]);
+  ASSERT_EQ(50, mid[2]);
+  ASSERT_EQ(true, m.find_keys(41, 49).empty());
+  ASSERT_EQ("30", m[30]);
+  ASSERT_EQ("50", m[50]);
+}
+
+TEST(BasicBinSearchMapTests, SplitLayoutTieredCheck)
+{
+  BinSearchMap<int,int,TieredSeq,SplitLayout> m;
+  for (int k = 0; k < 1000; ++k)
+    m.insert((k * 7919) % 1000, k);
+  for (int k = 0; k < 1000; k += 2)
+    m.erase(k);
+  ASSERT_EQ(500, m.size());
+  ASSERT_EQ(7919 % 1000 == 919 ? 1 : 0, m[919]);
+  ASSERT_EQ(3, m.find_keys(100, 105).size());
+  ASSERT_EQ(999, m.sorted_keys()[499]);
+}
+
+//----------------------------------------------------------------------
+// Basic Tests for the Eytzinger layout (StaticMap) implementation of Map
+//----------------------------------------------------------------------
+
+TEST(BasicStaticMapTests, EmptyCheck)
+{
+  StaticMap<char,int> m;
+  ASSERT_EQ(true, m.empty());
+  ASSERT_EQ(0, m.size());
+}
+
+TEST(BasicStaticMapTests, InsertCheck)
+{
+  StaticMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  ASSERT_EQ(false, m.empty());
+  ASSERT_EQ(4, m.size());
+}
+
+TEST(BasicStaticMapTests, RValueAccessCheck)
+{
+  StaticMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  ASSERT_EQ(4, m.size());
+  ASSERT_EQ(10, m['a']);
+  ASSERT_EQ(20, m['b']);
+  ASSERT_EQ(30, m['c']);
+  ASSERT_EQ(40, m['d']);
+}
+
+TEST(BasicStaticMapTests, LValueAccessCheck)
+{
+  StaticMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  m['a'] = 40;
+  m['b'] = 30;
+  m['c'] = 20;
+  m['d'] = 10;
+  ASSERT_EQ(40, m['a']);
+  ASSERT_EQ(30, m['b']);
+  ASSERT_EQ(20, m['c']);
+  ASSERT_EQ(10, m['d']);
+}
+
+TEST(BasicStaticMapTests, ContainsCheck)
+{
+  StaticMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  ASSERT_EQ(true, m.contains('a'));
+  ASSERT_EQ(true, m.contains('b'));
+  ASSERT_EQ(true, m.contains('c'));
+  ASSERT_EQ(true, m.contains('d'));
+  ASSERT_EQ(false, m.contains('e'));
+}
+
+TEST(BasicStaticMapTests, EraseCheck)
+{
+  StaticMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  ASSERT_EQ(4, m.size());
+  m.erase('a');
+  ASSERT_EQ(3, m.size());
+  ASSERT_EQ(false, m.contains('a'));
+  m.erase('c');
+  ASSERT_EQ(2, m.size());
+  ASSERT_EQ(false, m.contains('c'));
+  m.erase('d');
+  ASSERT_EQ(1, m.size());
+  ASSERT_EQ(false, m.contains('d'));
+  m.erase('b');
+  ASSERT_EQ(0, m.size());
+  ASSERT_EQ(false, m.contains('b'));
+}
+
+TEST(BasicStaticMapTests, KeyRangeCheck)
+{
+  StaticMap<char,int> m;
+  m.insert('b', 10);
+  m.insert('c', 20);
+  m.insert('d', 30);
+  m.insert('e', 40);
+  ArraySeq<char> k;
+  k = m.find_keys('b', 'd');
+  ASSERT_EQ(3, k.size());
+  ASSERT_EQ(true, k.contains('b') and k.contains('c') and k.contains('d'));
+  k = m.find_keys('a', 'c');
+  ASSERT_EQ(2, k.size());
+  ASSERT_EQ(true, k.contains('b') and k.contains('c'));
+  k = m.find_keys('d', 'f');
+  ASSERT_EQ(2, k.size());
+  ASSERT_EQ(true, k.contains('d') and k.contains('e'));
+}
+
+TEST(BasicStaticMapTests, SortedKeyCheck)
+{
+  StaticMap<char,int> m;
+  m.insert('e', 50);
+  m.insert('a', 10);
+  m.insert('c', 30);
+  m.insert('b', 20);
+  m.insert('d', 40);
+  ArraySeq<char> k;
+  k = m.sorted_keys();
+  ASSERT_EQ(5, k.size());
+  ASSERT_EQ('a', k[0]);
+  ASSERT_EQ('b', k[1]);
+  ASSERT_EQ('c', k[2]);  
+  ASSERT_EQ('d', k[3]);  
+  ASSERT_EQ('e', k[4]);  
+}
+
+TEST(BasicStaticMapTests, InvalidKeyCheck)
+{
+  StaticMap<char,int> m;
+  int x = 10;
+  EXPECT_THROW(m['a'] = x, std::out_of_range);
+  EXPECT_THROW(x = m['a'], std::out_of_range);
+  EXPECT_THROW(m.erase('a'), std::out_of_range);
+  m.insert('a', 10);
+  m.insert('c', 30);
+  EXPECT_THROW(m['b'] = x, std::out_of_range);
+  EXPECT_THROW(x = m['b'], std::out_of_range);
+  EXPECT_THROW(m.erase('b'), std::out_of_range);
+}
+
+TEST(BasicStaticMapTests, BulkBuildCheck)
+{
+  // sizes around powers of two, so the last tree level is partly full
+  for (int n : {1, 2, 3, 7, 8, 9, 100, 1023, 1024, 1025}) {
+    BinSearchMap<int,string> b;
+    for (int i = n - 1; i >= 0; --i)
+      b.insert(2 * i + 1, to_string(i));
+    StaticMap<int,string> m(b);
+    ASSERT_EQ(n, m.size());
+    for (int i = 0; i < n; ++i) {
+      ASSERT_EQ(to_string(i), m[2 * i + 1]);
+      ASSERT_EQ(false, m.contains(2 * i));
+    }
+    ASSERT_EQ(false, m.contains(2 * n + 1));
+    ArraySeq<int> keys = m.sorted_keys();
+    ASSERT_EQ(n, keys.size());
+    for (int i = 0; i < n; ++i)
+      ASSERT_EQ(2 * i + 1, keys[i]);
+    ASSERT_EQ(std::min(n, 3), m.find_keys(0, 6).size());
+    ASSERT_EQ(0, m.find_keys(2 * n, 3 * n).size());
+  }
+  // values come out in key order from either layout
+  BinSearchMap<int,string,ArraySeq,SplitLayout> split;
+  for (int k : {30, 10, 20})
+    split.insert(k, to_string(k));
+  ArraySeq<string> split_values = split.sorted_values();
+  ASSERT_EQ(3, split_values.size());
+  ASSERT_EQ("10", split_values[0]);
+  ASSERT_EQ("30", split_values[2]);
+  StaticMap<int,string> from_split(split);
+  ASSERT_EQ("20", from_split[20]);
+  ArraySeq<int> keys;
+  ArraySeq<int> values;
+  for (int i = 0; i < 10; ++i) {
+    keys.insert(i, i);
+    values.insert(10 * i, i);
+  }
+  StaticMap<int,int> m(keys, values);
+  ASSERT_EQ(90, m[9]);
+  ASSERT_EQ(true, m.try_emplace(-1, 5));
+  ASSERT_EQ(false, m.try_emplace(3, 6));
+  ASSERT_EQ(-1, m.sorted_keys()[0]);
+  ASSERT_EQ(30, m[3]);
+  values.erase(0);
+  EXPECT_THROW((StaticMap<int,int>(keys, values)), std::out_of_range);
+}
+
+
+//----------------------------------------------------------------------
+// Basic Tests for the open addressing (HashMap) implementation of Map
+//----------------------------------------------------------------------
+
+TEST(BasicHashMapTests, EmptyCheck)
+{
+  HashMap<char,int> m;
+  ASSERT_EQ(true, m.empty());
+  ASSERT_EQ(0, m.size());
+}
+
+TEST(BasicHashMapTests, InsertCheck)
+{
+  HashMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  ASSERT_EQ(false, m.empty());
+  ASSERT_EQ(4, m.size());
+}
+
+TEST(BasicHashMapTests, RValueAccessCheck)
+{
+  HashMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  ASSERT_EQ(4, m.size());
+  ASSERT_EQ(10, m['a']);
+  ASSERT_EQ(20, m['b']);
+  ASSERT_EQ(30, m['c']);
+  ASSERT_EQ(40, m['d']);
+}
+
+TEST(BasicHashMapTests, LValueAccessCheck)
+{
+  HashMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  m['a'] = 40;
+  m['b'] = 30;
+  m['c'] = 20;
+  m['d'] = 10;
+  ASSERT_EQ(40, m['a']);
+  ASSERT_EQ(30, m['b']);
+  ASSERT_EQ(20, m['c']);
+  ASSERT_EQ(10, m['d']);
+}
+
+TEST(BasicHashMapTests, ContainsCheck)
+{
+  HashMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  ASSERT_EQ(true, m.contains('a'));
+  ASSERT_EQ(true, m.contains('b'));
+  ASSERT_EQ(true, m.contains('c'));
+  ASSERT_EQ(true, m.contains('d'));
+  ASSERT_EQ(false, m.contains('e'));
+}
+
+TEST(BasicHashMapTests, EraseCheck)
+{
+  HashMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  ASSERT_EQ(4, m.size());
+  m.erase('a');
+  ASSERT_EQ(3, m.size());
+  ASSERT_EQ(false, m.contains('a'));
+  m.erase('c');
+  ASSERT_EQ(2, m.size());
+  ASSERT_EQ(false, m.contains('c'));
+  m.erase('d');
+  ASSERT_EQ(1, m.size());
+  ASSERT_EQ(false, m.contains('d'));
+  m.erase('b');
+  ASSERT_EQ(0, m.size());
+  ASSERT_EQ(false, m.contains('b'));
+}
+
+TEST(BasicHashMapTests, KeyRangeCheck)
+{
+  HashMap<char,int> m;
+  m.insert('b', 10);
+  m.insert('c', 20);
+  m.insert('d', 30);
+  m.insert('e', 40);
+  ArraySeq<char> k;
+  k = m.find_keys('b', 'd');
+  ASSERT_EQ(3, k.size());
+  ASSERT_EQ(true, k.contains('b') and k.contains('c') and k.contains('d'));
+  k = m.find_keys('a', 'c');
+  ASSERT_EQ(2, k.size());
+  ASSERT_EQ(true, k.contains('b') and k.contains('c'));
+  k = m.find_keys('d', 'f');
+  ASSERT_EQ(2, k.size());
+  ASSERT_EQ(true, k.contains('d') and k.contains('e'));
+}
+
+TEST(BasicHashMapTests, SortedKeyCheck)
+{
+  HashMap<char,int> m;
+  m.insert('e', 50);
+  m.insert('a', 10);
+  m.insert('c', 30);
+  m.insert('b', 20);
+  m.insert('d', 40);
+  ArraySeq<char> k;
+  k = m.sorted_keys();
+  ASSERT_EQ(5, k.size());
+  ASSERT_EQ('a', k[0]);
+  ASSERT_EQ('b', k[1]);
+  ASSERT_EQ('c', k[2]);  
+  ASSERT_EQ('d', k[3]);  
+  ASSERT_EQ('e', k[4]);  
+}
+
+TEST(BasicHashMapTests, InvalidKeyCheck)
+{
+  HashMap<char,int> m;
+  int x = 10;
+  EXPECT_THROW(m['a'] = x, std::out_of_range);
+  EXPECT_THROW(x = m['a'], std::out_of_range);
+  EXPECT_THROW(m.erase('a'), std::out_of_range);
+  m.insert('a', 10);
+  m.insert('c', 30);
+  EXPECT_THROW(m['b'] = x, std::out_of_range);
+  EXPECT_THROW(x = m['b'], std::out_of_range);
+  EXPECT_THROW(m.erase('b'), std::out_of_range);
+}
+
+// hashes every key to the same value, so all keys share one probe run
+struct ConstantHash
+{
+  std::size_t operator()(int) const { return 42; }
+};
+
+TEST(BasicHashMapTests, ManyKeysCheck)
+{
+  HashMap<int,int> m;
+  for (int i = 0; i < 1000; ++i)
+    m.insert((i * 7919) % 1000, i);
+  for (int k = 0; k < 1000; k += 2)
+    m.erase(k);
+  ASSERT_EQ(500, m.size());
+  for (int k = 0; k < 1000; ++k)
+    ASSERT_EQ(k % 2 == 1, m.contains(k));
+  ArraySeq<int> keys = m.sorted_keys();
+  for (int i = 0; i < 500; ++i)
+    ASSERT_EQ(2 * i + 1, keys[i]);
+  ArraySeq<int> range = m.find_keys(100, 110);
+  ASSERT_EQ(5, range.size());
+  ASSERT_EQ(101, range[0]);
+  ASSERT_EQ(109, range[4]);
+  HashMap<int,int> copy = m;
+  m.erase(1);
+  ASSERT_EQ(true, copy.contains(1));
+  ASSERT_EQ(copy[999], m[999]);
+}
+
+TEST(BasicHashMapTests, ChurnCheck)
+{
+  // random inserts and erases, so runs of different home slots meet
+  // and erases must move pairs from later homes back past the hole
+  HashMap<int,int> m;
+  ArraySeq<int> present;
+  for (int k = 0; k < 3000; ++k)
+    present.insert(0, k);
+  unsigned r = 1;
+  for (int i = 0; i < 50000; ++i) {
+    r = r * 1664525 + 1013904223;
+    int k = (r >> 8) % 3000;
+    if (present[k] == 0 and (r & 3) != 0) {
+      m.insert(k, k);
+      present[k] = 1;
+    }
+    else if (present[k] == 1) {
+      m.erase(k);
+      present[k] = 0;
+    }
+  }
+  int n = 0;
+  for (int k = 0; k < 3000; ++k) {
+    ASSERT_EQ(present[k] == 1, m.contains(k));
+    n += present[k];
+  }
+  ASSERT_EQ(n, m.size());
+}
+
+TEST(BasicHashMapTests, CollisionEraseCheck)
+{
+  // one long run that wraps around the end of the table, erased from
+  // the middle so later keys must shift back past the wrap
+  HashMap<int,string,ConstantHash> m;
+  for (int k = 0; k < 100; ++k)
+    m.insert(k, to_string(k));
+  for (int k = 0; k < 100; k += 3)
+    m.erase(k);
+  ASSERT_EQ(66, m.size());
+  for (int k = 0; k < 100; ++k) {
+    ASSERT_EQ(k % 3 != 0, m.contains(k));
+    if (k % 3 != 0) {
+      ASSERT_EQ(to_string(k), m[k]);
+    }
+  }
+  ASSERT_EQ(true, m.try_emplace(0, 2, 'z'));
+  ASSERT_EQ(false, m.try_emplace(1, "other"));
+  ASSERT_EQ("zz", m[0]);
+  ASSERT_EQ("1", m[1]);
+}
+
+
+//----------------------------------------------------------------------
+// Basic Tests for the B+tree (BTreeMap) implementation of Map
+//----------------------------------------------------------------------
+
+TEST(BasicBTreeMapTests, EmptyCheck)
+{
+  BTreeMap<char,int> m;
+  ASSERT_EQ(true, m.empty());
+  ASSERT_EQ(0, m.size());
+}
+
+TEST(BasicBTreeMapTests, InsertCheck)
+{
+  BTreeMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  ASSERT_EQ(false, m.empty());
+  ASSERT_EQ(4, m.size());
+}
+
+TEST(BasicBTreeMapTests, RValueAccessCheck)
+{
+  BTreeMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  ASSERT_EQ(4, m.size());
+  ASSERT_EQ(10, m['a']);
+  ASSERT_EQ(20, m['b']);
+  ASSERT_EQ(30, m['c']);
+  ASSERT_EQ(40, m['d']);
+}
+
+TEST(BasicBTreeMapTests, LValueAccessCheck)
+{
+  BTreeMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  m['a'] = 40;
+  m['b'] = 30;
+  m['c'] = 20;
+  m['d'] = 10;
+  ASSERT_EQ(40, m['a']);
+  ASSERT_EQ(30, m['b']);
+  ASSERT_EQ(20, m['c']);
+  ASSERT_EQ(10, m['d']);
+}
+
+TEST(BasicBTreeMapTests, ContainsCheck)
+{
+  BTreeMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  ASSERT_EQ(true, m.contains('a'));
+  ASSERT_EQ(true, m.contains('b'));
+  ASSERT_EQ(true, m.contains('c'));
+  ASSERT_EQ(true, m.contains('d'));
+  ASSERT_EQ(false, m.contains('e'));
+}
+
+TEST(BasicBTreeMapTests, EraseCheck)
+{
+  BTreeMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  ASSERT_EQ(4, m.size());
+  m.erase('a');
+  ASSERT_EQ(3, m.size());
+  ASSERT_EQ(false, m.contains('a'));
+  m.erase('c');
+  ASSERT_EQ(2, m.size());
+  ASSERT_EQ(false, m.contains('c'));
+  m.erase('d');
+  ASSERT_EQ(1, m.size());
+  ASSERT_EQ(false, m.contains('d'));
+  m.erase('b');
+  ASSERT_EQ(0, m.size());
+  ASSERT_EQ(false, m.contains('b'));
+}
+
+TEST(BasicBTreeMapTests, KeyRangeCheck)
+{
+  BTreeMap<char,int> m;
+  m.insert('b', 10);
+  m.insert('c', 20);
+  m.insert('d', 30);
+  m.insert('e', 40);
+  ArraySeq<char> k;
+  k = m.find_keys('b', 'd');
+  ASSERT_EQ(3, k.size());
+  ASSERT_EQ(true, k.contains('b') and k.contains('c') and k.contains('d'));
+  k = m.find_keys('a', 'c');
+  ASSERT_EQ(2, k.size());
+  ASSERT_EQ(true, k.contains('b') and k.contains('c'));
+  k = m.find_keys('d', 'f');
+  ASSERT_EQ(2, k.size());
+  ASSERT_EQ(true, k.contains('d') and k.contains('e'));
+}
+
+TEST(BasicBTreeMapTests, SortedKeyCheck)
+{
+  BTreeMap<char,int> m;
+  m.insert('e', 50);
+  m.insert('a', 10);
+  m.insert('c', 30);
+  m.insert('b', 20);
+  m.insert('d', 40);
+  ArraySeq<char> k;
+  k = m.sorted_keys();
+  ASSERT_EQ(5, k.size());
+  ASSERT_EQ('a', k[0]);
+  ASSERT_EQ('b', k[1]);
+  ASSERT_EQ('c', k[2]);  
+  ASSERT_EQ('d', k[3]);  
+  ASSERT_EQ('e', k[4]);  
+}
+
+TEST(BasicBTreeMapTests, InvalidKeyCheck)
+{
+  BTreeMap<char,int> m;
+  int x = 10;
+  EXPECT_THROW(m['a'] = x, std::out_of_range);
+  EXPECT_THROW(x = m['a'], std::out_of_range);
+  EXPECT_THROW(m.erase('a'), std::out_of_range);
+  m.insert('a', 10);
+  m.insert('c', 30);
+  EXPECT_THROW(m['b'] = x, std::out_of_range);
+  EXPECT_THROW(x = m['b'], std::out_of_range);
+  EXPECT_THROW(m.erase('b'), std::out_of_range);
+}
+
+TEST(BasicBTreeMapTests, ManyKeysCheck)
+{
+  // small nodes, so the tree is several levels deep and erases merge
+  // and borrow at every level
+  BTreeMap<int,string,4> m;
+  for (int i = 0; i < 2000; ++i)
+    m.insert((i * 7919) % 2000, to_string(i));
+  ASSERT_EQ(2000, m.size());
+  for (int k = 0; k < 2000; k += 2)
+    m.erase(k);
+  ASSERT_EQ(1000, m.size());
+  for (int k = 0; k < 2000; ++k)
+    ASSERT_EQ(k % 2 == 1, m.contains(k));
+  ASSERT_EQ(to_string(1), m[7919 % 2000]);
+  ArraySeq<int> keys = m.sorted_keys();
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_EQ(2 * i + 1, keys[i]);
+  ArraySeq<int> range = m.find_keys(100, 140);
+  ASSERT_EQ(20, range.size());
+  ASSERT_EQ(101, range[0]);
+  ASSERT_EQ(139, range[19]);
+  for (int k = 1999; k > 0; k -= 2)
+    m.erase(k);
+  ASSERT_EQ(true, m.empty());
+  ASSERT_EQ(0, m.sorted_keys().size());
+  m.insert(5, "five");
+  ASSERT_EQ("five", m[5]);
+}
+
+TEST(BasicBTreeMapTests, BulkLoadCheck)
+{
+  for (int n : {0, 1, 4, 5, 24, 25, 26, 1000}) {
+    ArraySeq<int> keys;
+    ArraySeq<string> values;
+    for (int i = 0; i < n; ++i) {
+      keys.insert(2 * i, i);
+      values.insert(to_string(i), i);
+    }
+    BTreeMap<int,string,4> m(keys, values);
+    ASSERT_EQ(n, m.size());
+    for (int i = 0; i < n; ++i) {
+      ASSERT_EQ(to_string(i), m[2 * i]);
+      ASSERT_EQ(false, m.contains(2 * i + 1));
+    }
+    ASSERT_EQ(keys.size(), m.sorted_keys().size());
+    // the bulk loaded tree still takes inserts and erases
+    BTreeMap<int,string,4> copy = m;
+    for (int i = 0; i < n; ++i) {
+      copy.insert(2 * i + 1, "odd");
+      copy.erase(2 * i);
+    }
+    ASSERT_EQ(n, copy.size());
+    ASSERT_EQ(n, m.size());
+    ASSERT_EQ(std::min(n, 3), copy.find_keys(0, 6).size());
+  }
+  ArraySeq<int> keys;
+  ArraySeq<string> values;
+  keys.insert(1, 0);
+  EXPECT_THROW((BTreeMap<int,string>(keys, values)), std::out_of_range);
+}
+
+
+//----------------------------------------------------------------------
+// Basic Tests for the AVL tree (TreeMap) implementation of Map
+//----------------------------------------------------------------------
+
+TEST(BasicTreeMapTests, EmptyCheck)
+{
+  TreeMap<char,int> m;
+  ASSERT_EQ(true, m.empty());
+  ASSERT_EQ(0, m.size());
+}
+
+TEST(BasicTreeMapTests, InsertCheck)
+{
+  TreeMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  ASSERT_EQ(false, m.empty());
+  ASSERT_EQ(4, m.size());
+}
+
+TEST(BasicTreeMapTests, RValueAccessCheck)
+{
+  TreeMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  ASSERT_EQ(4, m.size());
+  ASSERT_EQ(10, m['a']);
+  ASSERT_EQ(20, m['b']);
+  ASSERT_EQ(30, m['c']);
+  ASSERT_EQ(40, m['d']);
+}
+
+TEST(BasicTreeMapTests, LValueAccessCheck)
+{
+  TreeMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  m['a'] = 40;
+  m['b'] = 30;
+  m['c'] = 20;
+  m['d'] = 10;
+  ASSERT_EQ(40, m['a']);
+  ASSERT_EQ(30, m['b']);
+  ASSERT_EQ(20, m['c']);
+  ASSERT_EQ(10, m['d']);
+}
+
+TEST(BasicTreeMapTests, ContainsCheck)
+{
+  TreeMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  ASSERT_EQ(true, m.contains('a'));
+  ASSERT_EQ(true, m.contains('b'));
+  ASSERT_EQ(true, m.contains('c'));
+  ASSERT_EQ(true, m.contains('d'));
+  ASSERT_EQ(false, m.contains('e'));
+}
+
+TEST(BasicTreeMapTests, EraseCheck)
+{
+  TreeMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  ASSERT_EQ(4, m.size());
+  m.erase('a');
+  ASSERT_EQ(3, m.size());
+  ASSERT_EQ(false, m.contains('a'));
+  m.erase('c');
+  ASSERT_EQ(2, m.size());
+  ASSERT_EQ(false, m.contains('c'));
+  m.erase('d');
+  ASSERT_EQ(1, m.size());
+  ASSERT_EQ(false, m.contains('d'));
+  m.erase('b');
+  ASSERT_EQ(0, m.size());
+  ASSERT_EQ(false, m.contains('b'));
+}
+
+TEST(BasicTreeMapTests, KeyRangeCheck)
+{
+  TreeMap<char,int> m;
+  m.insert('b', 10);
+  m.insert('c', 20);
+  m.insert('d', 30);
+  m.insert('e', 40);
+  ArraySeq<char> k;
+  k = m.find_keys('b', 'd');
+  ASSERT_EQ(3, k.size());
+  ASSERT_EQ(true, k.contains('b') and k.contains('c') and k.contains('d'));
+  k = m.find_keys('a', 'c');
+  ASSERT_EQ(2, k.size());
+  ASSERT_EQ(true, k.contains('b') and k.contains('c'));
+  k = m.find_keys('d', 'f');
+  ASSERT_EQ(2, k.size());
+  ASSERT_EQ(true, k.contains('d') and k.contains('e'));
+}
+
+TEST(BasicTreeMapTests, SortedKeyCheck)
+{
+  TreeMap<char,int> m;
+  m.insert('e', 50);
+  m.insert('a', 10);
+  m.insert('c', 30);
+  m.insert('b', 20);
+  m.insert('d', 40);
+  ArraySeq<char> k;
+  k = m.sorted_keys();
+  ASSERT_EQ(5, k.size());
+  ASSERT_EQ('a', k[0]);
+  ASSERT_EQ('b', k[1]);
+  ASSERT_EQ('c', k[2]);  
+  ASSERT_EQ('d', k[3]);  
+  ASSERT_EQ('e', k[4]);  
+}
+
+TEST(BasicTreeMapTests, InvalidKeyCheck)
+{
+  TreeMap<char,int> m;
+  int x = 10;
+  EXPECT_THROW(m['a'] = x, std::out_of_range);
+  EXPECT_THROW(x = m['a'], std::out_of_range);
+  EXPECT_THROW(m.erase('a'), std::out_of_range);
+  m.insert('a', 10);
+  m.insert('c', 30);
+  EXPECT_THROW(m['b'] = x, std::out_of_range);
+  EXPECT_THROW(x = m['b'], std::out_of_range);
+  EXPECT_THROW(m.erase('b'), std::out_of_range);
+}
+
+TEST(BasicTreeMapTests, ManyKeysCheck)
+{
+  // ascending inserts would make an unbalanced tree a list
+  TreeMap<int,string> m;
+  for (int i = 0; i < 2000; ++i)
+    m.insert(i, to_string(i));
+  ASSERT_EQ(2000, m.size());
+  for (int k = 0; k < 2000; k += 2)
+    m.erase(k);
+  ASSERT_EQ(1000, m.size());
+  for (int k = 0; k < 2000; ++k)
+    ASSERT_EQ(k % 2 == 1, m.contains(k));
+  ASSERT_EQ(to_string(7), m[7]);
+  ArraySeq<int> keys = m.sorted_keys();
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_EQ(2 * i + 1, keys[i]);
+  ArraySeq<int> range = m.find_keys(100, 140);
+  ASSERT_EQ(20, range.size());
+  ASSERT_EQ(101, range[0]);
+  ASSERT_EQ(139, range[19]);
+  // copies are independent of the original
+  TreeMap<int,string> copy = m;
+  for (int k = 1999; k > 0; k -= 2)
+    m.erase(k);
+  ASSERT_EQ(true, m.empty());
+  ASSERT_EQ(0, m.sorted_keys().size());
+  ASSERT_EQ(1000, copy.size());
+  ASSERT_EQ(to_string(1999), copy[1999]);
+  ASSERT_EQ(true, copy.try_emplace(0, 3, 'x'));
+  ASSERT_EQ(false, copy.try_emplace(0, "no"));
+  ASSERT_EQ("xxx", copy[0]);
+  m = std::move(copy);
+  ASSERT_EQ(1001, m.size());
+  ASSERT_EQ(0, copy.size());
+}
+
+
+//----------------------------------------------------------------------
+// Basic Tests for the UnrolledSeq implementation of Map
+//----------------------------------------------------------------------
+
+TEST(BasicUnrolledMapTests, EmptyCheck)
+{
+  UnrolledMap<char,int> m;
+  ASSERT_EQ(true, m.empty());
+  ASSERT_EQ(0, m.size());
+}
+
+TEST(BasicUnrolledMapTests, InsertCheck)
+{
+  UnrolledMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  ASSERT_EQ(false, m.empty());
+  ASSERT_EQ(4, m.size());
+}
+
+TEST(BasicUnrolledMapTests, RValueAccessCheck)
+{
+  UnrolledMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  ASSERT_EQ(4, m.size());
+  ASSERT_EQ(10, m['a']);
+  ASSERT_EQ(20, m['b']);
+  ASSERT_EQ(30, m['c']);
+  ASSERT_EQ(40, m['d']);
+}
+
+TEST(BasicUnrolledMapTests, LValueAccessCheck)
+{
+  UnrolledMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  m['a'] = 40;
+  m['b'] = 30;
+  m['c'] = 20;
+  m['d'] = 10;
+  ASSERT_EQ(40, m['a']);
+  ASSERT_EQ(30, m['b']);
+  ASSERT_EQ(20, m['c']);
+  ASSERT_EQ(10, m['d']);
+}
+
+TEST(BasicUnrolledMapTests, ContainsCheck)
+{
+  UnrolledMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  ASSERT_EQ(true, m.contains('a'));
+  ASSERT_EQ(true, m.contains('b'));
+  ASSERT_EQ(true, m.contains('c'));
+  ASSERT_EQ(true, m.contains('d'));
+  ASSERT_EQ(false, m.contains('e'));
+}
+
+TEST(BasicUnrolledMapTests, EraseCheck)
+{
+  UnrolledMap<char,int> m;
+  m.insert('a', 10);
+  m.insert('b', 20);
+  m.insert('c', 30);
+  m.insert('d', 40);
+  ASSERT_EQ(4, m.size());
+  m.erase('a');
+  ASSERT_EQ(3, m.size());
+  ASSERT_EQ(false, m.contains('a'));
+  m.erase('c');
+  ASSERT_EQ(2, m.size());
+  ASSERT_EQ(false, m.contains('c'));
+  m.erase('d');
+  ASSERT_EQ(1, m.size());
+  ASSERT_EQ(false, m.contains('d'));
+  m.erase('b');
+  ASSERT_EQ(0, m.size());
+  ASSERT_EQ(false, m.contains('b'));
+}
+
+TEST(BasicUnrolledMapTests, KeyRangeCheck)
+{
+  UnrolledMap<char,int> m;
+  m.insert('b', 10);
+  m.insert('c', 20);
+  m.insert('d', 30);
+  m.insert('e', 40);
+  ArraySeq<char> k;
+  k = m.find_keys('b', 'd');
+  ASSERT_EQ(3, k.size());
+  ASSERT_EQ(true, k.contains('b') and k.contains('c') and k.contains('d'));
+  k = m.find_keys('a', 'c');
+  ASSERT_EQ(2, k.size());
+  ASSERT_EQ(true, k.contains('b') and k.contains('c'));
+  k = m.find_keys('d', 'f');
+  ASSERT_EQ(2, k.size());
+  ASSERT_EQ(true, k.contains('d') and k.contains('e'));
+}
+
+TEST(BasicUnrolledMapTests, SortedKeyCheck)
+{
+  UnrolledMap<char,int> m;
+  m.insert('e', 50);
+  m.insert('a', 10);
+  m.insert('c', 30);
+  m.insert('b', 20);
+  m.insert('d', 40);
+  ArraySeq<char> k;
+  k = m.sorted_keys();
+  ASSERT_EQ(5, k.size());
+  ASSERT_EQ('a', k[0]);
+  ASSERT_EQ('b', k[1]);
+  ASSERT_EQ('c', k[2]);  
+  ASSERT_EQ('d', k[3]);  
+  ASSERT_EQ('e', k[4]);  
+}
+
+TEST(BasicUnrolledMapTests, InvalidKeyCheck)
+{
+  UnrolledMap<char,int> m;
+  int x = 10;
+  EXPECT_THROW(m['a'] = x, std::out_of_range);
+  EXPECT_THROW(x = m['a'], std::out_of_range);
+  EXPECT_THROW(m.erase('a'), std::out_of_range);
+  m.insert('a', 10);
+  m.insert('c', 30);
+  EXPECT_THROW(m['b'] = x, std::out_of_range);
+  EXPECT_THROW(x = m['b'], std::out_of_range);
+  EXPECT_THROW(m.erase('b'), std::out_of_range);
+}
+
+TEST(BasicUnrolledMapTests, ManyKeysCheck)
+{
+  UnrolledMap<int,int> m;
+  for (int i = 0; i < 1000; ++i)
+    m.insert((i * 7919) % 1000, i);
+  for (int k = 0; k < 1000; k += 2)
+    m.erase(k);
+  ASSERT_EQ(500, m.size());
+  ASSERT_EQ(false, m.contains(500));
+  ASSERT_EQ(true, m.contains(501));
+  ASSERT_EQ(919, m.find_keys(919, 919)[0]);
+  ArraySeq<int> keys = m.sorted_keys();
+  for (int i = 0; i < 500; ++i)
+    ASSERT_EQ(2 * i + 1, keys[i]);
+}
+
+
+//----------------------------------------------------------------------
+// Basic Tests for the ArraySeq implementation of Sequence
+//----------------------------------------------------------------------
+
+TEST(BasicArraySeqTests, ReserveCheck)
+{
+  ArraySeq<int> s;
+  s.reserve(100);
+  ASSERT_EQ(100, s.capacity());
+  ASSERT_EQ(0, s.size());
+  for (int i = 0; i < 100; ++i)
+    s.insert(i, i);
+  ASSERT_EQ(100, s.capacity());
+  ASSERT_EQ(100, s.size());
+  s.reserve(10);
+  ASSERT_EQ(100, s.capacity());
+  ASSERT_EQ(99, s[99]);
+}
+
+TEST(BasicArraySeqTests, ShrinkToFitCheck)
+{
+  ArraySeq<int> s;
+  s.reserve(100);
+  s.insert(10, 0);
+  s.insert(20, 1);
+  s.shrink_to_fit();
+  ASSERT_EQ(2, s.capacity());
+  ASSERT_EQ(10, s[0]);
+  ASSERT_EQ(20, s[1]);
+}
+
+TEST(BasicArraySeqTests, NonTrivialInsertEraseCheck)
+{
+  ArraySeq<string> s;
+  s.insert("b", 0);
+  s.insert("d", 1);
+  s.insert("a", 0);
+  s.insert("c", 2);
+  s.insert(s[3], 4);
+  ASSERT_EQ(5, s.size());
+  ASSERT_EQ("a", s[0]);
+  ASSERT_EQ("b", s[1]);
+  ASSERT_EQ("c", s[2]);
+  ASSERT_EQ("d", s[3]);
+  ASSERT_EQ("d", s[4]);
+  s.erase(0);
+  s.erase(1);
+  ASSERT_EQ(3, s.size());
+  ASSERT_EQ("b", s[0]);
+  ASSERT_EQ("d", s[1]);
+  ASSERT_EQ("d", s[2]);
+}
+
+TEST(BasicArraySeqTests, EmplaceCheck)
+{
+  ArraySeq<string> s;
+  ASSERT_EQ("aaa", s.emplace(0, 3, 'a'));
+  s.emplace(0, "b");
+  s.emplace(2, s[0]);
+  string c = "c";
+  s.insert(std::move(c), 1);
+  ASSERT_EQ(true, c.empty());
+  ASSERT_EQ(4, s.size());
+  ASSERT_EQ("b", s[0]);
+  ASSERT_EQ("c", s[1]);
+  ASSERT_EQ("aaa", s[2]);
+  ASSERT_EQ("b", s[3]);
+  EXPECT_THROW(s.emplace(5, "d"), std::out_of_range);
+}
+
+TEST(BasicArraySeqTests, IteratorCheck)
+{
+  ArraySeq<int> s;
+  ASSERT_EQ(s.begin(), s.end());
+  for (int i = 0; i < 100; ++i)
+    s.insert(2 * i, i);
+  ASSERT_EQ(s.data(), s.begin());
+  ASSERT_EQ(s.size(), s.end() - s.begin());
+  const ArraySeq<int>& c = s;
+  ASSERT_EQ(c.cbegin(), c.begin());
+  ASSERT_EQ(c.cend(), c.end());
+  int sum = 0;
+  for (int x : s)
+    sum += x;
+  ASSERT_EQ(9900, sum);
+  ASSERT_EQ(s.begin() + 21, std::find(s.begin(), s.end(), 42));
+  ASSERT_EQ(s.end(), std::find(c.cbegin(), c.cend(), 43));
+  ASSERT_EQ(s.begin() + 22, std::lower_bound(s.begin(), s.end(), 43));
+  ArraySeq<string> t;
+  for (int i = 0; i < 10; ++i)
+    t.insert(string(i, 'x'), i);
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(t[i], t.at_unchecked(i));
+    ASSERT_EQ(&t[i], &t.at_unchecked(i));
+  }
+  t.at_unchecked(3) = "y";
+  ASSERT_EQ("y", t[3]);
+}
+
+TEST(BasicArraySeqTests, RangeConstructCheck)
+{
+  int vals[] = {10, 20, 30, 40};
+  ArraySeq<int> s(vals, vals + 4);
+  ASSERT_EQ(4, s.size());
+  ASSERT_EQ(10, s[0]);
+  ASSERT_EQ(40, s[3]);
+  ArraySeq<int> t(s);
+  ASSERT_EQ(4, t.size());
+  ASSERT_EQ(30, t[2]);
+}
+
+TEST(BasicArraySeqTests, InsertRangeCheck)
+{
+  string vals[] = {"b", "c", "d"};
+  ArraySeq<string> s;
+  s.insert("a", 0);
+  s.insert("e", 1);
+  s.insert_range(1, vals, vals + 3);
+  ASSERT_EQ(5, s.size());
+  ASSERT_EQ("a", s[0]);
+  ASSERT_EQ("b", s[1]);
+  ASSERT_EQ("c", s[2]);
+  ASSERT_EQ("d", s[3]);
+  ASSERT_EQ("e", s[4]);
+  s.append(vals, vals + 2);
+  ASSERT_EQ(7, s.size());
+  ASSERT_EQ("c", s[6]);
+  EXPECT_THROW(s.insert_range(8, vals, vals + 1), std::out_of_range);
+}
+
+TEST(BasicArraySeqTests, SortCheck)
+{
+  ArraySeq<int> s;
+  for (int i = 0; i < 1000; ++i)
+    s.insert(1000 - i, i);
+  s.sort();
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_EQ(i + 1, s[i]);
+  s.sort();
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_EQ(i + 1, s[i]);
+  for (int i = 0; i < 1000; ++i)
+    s[i] = (i * 7) % 10;
+  s.sort();
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_EQ(i / 100, s[i]);
+}
+
+TEST(BasicArraySeqTests, IntroSortCheck)
+{
+  // strings are not radix sortable, so these all go through intro sort
+  const int n = 2000;
+  auto padded = [](int i) {
+    string digits = to_string(i);
+    return string(5 - digits.size(), '0') + digits;
+  };
+  ArraySeq<string> s;
+  for (int i = 0; i < n; ++i)
+    s.insert(padded(i), i);
+  s.sort();
+  for (int i = 0; i < n; ++i)
+    ASSERT_EQ(padded(i), s[i]);
+  for (int i = 0; i < n; ++i)
+    s[i] = padded(n - 1 - i);
+  s.sort();
+  for (int i = 0; i < n; ++i)
+    ASSERT_EQ(padded(i), s[i]);
+  for (int i = 0; i < n; ++i)
+    s[i] = padded((i * 7) % 10);
+  s.sort();
+  for (int i = 0; i < n; ++i)
+    ASSERT_EQ(padded(i / 200), s[i]);
+}
+
+TEST(BasicArraySeqTests, HeapSortCheck)
+{
+  ArraySeq<double> s;
+  s.heap_sort();
+  ASSERT_EQ(0, s.size());
+  for (int i = 0; i < 1000; ++i)
+    s.insert((i * 7919) % 1000 / 2.0, i);
+  s.heap_sort();
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_EQ(i / 2.0, s[i]);
+  for (int i = 0; i < 1000; ++i)
+    s[i] = double(i % 3);
+  s.heap_sort();
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_EQ(double(i * 3 / 1000), s[i]);
+}
+
+TEST(BasicArraySeqTests, MergeSortCheck)
+{
+  ArraySeq<int> s;
+  for (int i = 0; i < 100000; ++i)
+    s.insert(100000 - i, i);
+  s.merge_sort();
+  for (int i = 0; i < 100000; ++i)
+    ASSERT_EQ(i + 1, s[i]);
+  ArraySeq<string> t;
+  for (int i = 0; i < 100; ++i)
+    t.insert(to_string(i % 10), i);
+  t.merge_sort();
+  for (int i = 0; i < 100; ++i)
+    ASSERT_EQ(to_string(i / 10), t[i]);
+}
+
+TEST(BasicArraySeqTests, ParallelMergeSortCheck)
+{
+  ArraySeq<int> s;
+  for (int i = 0; i < 100000; ++i)
+    s.insert((i * 7919) % 100000, i);
+  s.parallel_merge_sort(4);
+  for (int i = 0; i < 100000; ++i)
+    ASSERT_EQ(i, s[i]);
+  s.parallel_merge_sort(3);
+  for (int i = 0; i < 100000; ++i)
+    ASSERT_EQ(i, s[i]);
+}
+
+TEST(BasicArraySeqTests, RadixSortCheck)
+{
+  ArraySeq<int> s;
+  for (int i = 0; i < 1000; ++i)
+    s.insert((i % 2 == 0) ? i : -i, i);
+  s.sort();
+  for (int i = 1; i < 1000; ++i)
+    ASSERT_EQ(true, s[i - 1] < s[i]);
+  ASSERT_EQ(-999, s[0]);
+  ASSERT_EQ(998, s[999]);
+  ArraySeq<pair<int,char>> p;
+  for (int i = 0; i < 100; ++i)
+    p.insert({i % 10, char('z' - i / 10)}, i);
+  p.sort();
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(i / 10, p[i].first);
+    ASSERT_EQ(char('z' - 9 + i % 10), p[i].second);
+  }
+}
+
+TEST(BasicArraySeqTests, IndexOfCheck)
+{
+  ArraySeq<int> s;
+  for (int i = 0; i < 100; ++i)
+    s.insert(i % 50, i);
+  ASSERT_EQ(0, s.index_of(0));
+  ASSERT_EQ(49, s.index_of(49));
+  ASSERT_EQ(-1, s.index_of(50));
+  ASSERT_EQ(true, s.contains(37));
+  ASSERT_EQ(false, s.contains(-1));
+  ArraySeq<string> t;
+  t.insert("a", 0);
+  t.insert("b", 1);
+  ASSERT_EQ(1, t.index_of("b"));
+  ASSERT_EQ(-1, t.index_of("c"));
+}
+
+// Checks index_of and contains for an element type with a vectorized
+// search. 103 elements leave a scalar tail after the vector loop for
+// every lane count (SSE2 and AVX2), so hits are checked in both.
+template<typename T>
+void check_simd_index_of()
+{
+  const int n = 103;
+  ArraySeq<T> s;
+  for (int i = 0; i < n; ++i)
+    s.insert(T(i + 1), i);
+  ASSERT_EQ(0, s.index_of(T(1)));
+  ASSERT_EQ(5, s.index_of(T(6)));
+  ASSERT_EQ(n - 2, s.index_of(T(n - 1)));
+  ASSERT_EQ(n - 1, s.index_of(T(n)));
+  ASSERT_EQ(-1, s.index_of(T(0)));
+  ASSERT_EQ(true, s.contains(T(n)));
+  ASSERT_EQ(false, s.contains(T(n + 1)));
+  // the first match wins
+  s.insert(T(n), 40);
+  ASSERT_EQ(40, s.index_of(T(n)));
+#ifdef SIMDFIND_SSE2
+  // the SSE2 path directly, in case the AVX2 one was taken above
+  if constexpr (std::is_integral<T>::value) {
+    ASSERT_EQ(5, simdfind_detail::sse2_find_int(s.data(), n, T(6)));
+    ASSERT_EQ(n - 1, simdfind_detail::sse2_find_int(s.data(), n, T(n - 1)));
+    ASSERT_EQ(-1, simdfind_detail::sse2_find_int(s.data(), n, T(0)));
+  }
+#endif
+}
+
+TEST(BasicArraySeqTests, SimdIndexOfCheck)
+{
+  check_simd_index_of<char>();
+  check_simd_index_of<short>();
+  check_simd_index_of<long long>();
+  check_simd_index_of<float>();
+  check_simd_index_of<double>();
+  // 8 byte lanes must match in both 4 byte halves
+  ArraySeq<long long> s;
+  for (int i = 0; i < 20; ++i)
+    s.insert(i, i);
+  ASSERT_EQ(-1, s.index_of((1LL << 32) + 5));
+  ASSERT_EQ(5, s.index_of(5));
+  ArraySeq<double> d;
+  d.insert(-0.0, 0);
+  d.insert(2.5, 1);
+  ASSERT_EQ(0, d.index_of(0.0));
+}
+
+
+//----------------------------------------------------------------------
+// Basic Tests for the LinkedSeq implementation of Sequence
+//----------------------------------------------------------------------
+
+TEST(BasicLinkedSeqTests, InsertEraseCheck)
+{
+  LinkedSeq<int> s;
+  ASSERT_EQ(true, s.empty());
+  s.insert(20, 0);
+  s.insert(40, 1);
+  s.insert(10, 0);
+  s.insert(30, 2);
+  ASSERT_EQ(4, s.size());
+  ASSERT_EQ(10, s[0]);
+  ASSERT_EQ(20, s[1]);
+  ASSERT_EQ(30, s[2]);
+  ASSERT_EQ(40, s[3]);
+  s.erase(3);
+  s.erase(0);
+  ASSERT_EQ(2, s.size());
+  ASSERT_EQ(20, s[0]);
+  ASSERT_EQ(30, s[1]);
+  ASSERT_EQ(true, s.contains(30));
+  ASSERT_EQ(false, s.contains(40));
+  EXPECT_THROW(s[2], std::out_of_range);
+  EXPECT_THROW(s.insert(50, 3), std::out_of_range);
+  EXPECT_THROW(s.erase(-1), std::out_of_range);
+}
+
+TEST(BasicLinkedSeqTests, CopyMoveCheck)
+{
+  LinkedSeq<string> s;
+  s.reserve(3);
+  s.insert("a", 0);
+  s.emplace(1, 2, 'b');
+  s.insert(s[0], 2);
+  LinkedSeq<string> t = s;
+  LinkedSeq<string> u = std::move(s);
+  ASSERT_EQ(0, s.size());
+  t.erase(0);
+  ASSERT_EQ(3, u.size());
+  ASSERT_EQ("a", u[0]);
+  ASSERT_EQ("bb", u[1]);
+  ASSERT_EQ("a", u[2]);
+  ASSERT_EQ(2, t.size());
+  ASSERT_EQ("bb", t[0]);
+  s = t;
+  ASSERT_EQ(2, s.size());
+  ASSERT_EQ("a", s[1]);
+}
+
+TEST(BasicLinkedSeqTests, SortCheck)
+{
+  LinkedSeq<int> s;
+  for (int i = 0; i < 1000; ++i)
+    s.insert((i * 7919) % 1000, s.size());
+  s.sort();
+  int expected = 0;
+  for (int x : s)
+    ASSERT_EQ(expected++, x);
+  ASSERT_EQ(999, s[999]);
+  s.insert(1000, s.size());
+  ASSERT_EQ(1000, s[1000]);
+}
+
+TEST(BasicLinkedSeqTests, EraseIteratorCheck)
+{
+  LinkedSeq<int> s;
+  for (int i = 0; i < 10; ++i)
+    s.insert(i, s.size());
+  // erase the odd elements in one pass
+  for (auto it = s.begin(); it != s.end(); ) {
+    if (*it % 2 == 1)
+      it = s.erase(it);
+    else
+      ++it;
+  }
+  ASSERT_EQ(5, s.size());
+  for (int i = 0; i < 5; ++i)
+    ASSERT_EQ(2 * i, s[i]);
+  s.erase(s.begin());
+  ASSERT_EQ(2, s[0]);
+  s.insert(10, s.size());
+  ASSERT_EQ(10, s[4]);
+}
+
+TEST(BasicLinkedSeqTests, HeapNodesCheck)
+{
+  LinkedSeq<int, HeapNodes> s;
+  for (int i = 0; i < 10; ++i)
+    s.insert(9 - i, s.size());
+  s.erase(5);
+  s.sort();
+  ASSERT_EQ(9, s.size());
+  ASSERT_EQ(0, s[0]);
+  ASSERT_EQ(3, s[3]);
+  ASSERT_EQ(5, s[4]);
+}
+
+
+//----------------------------------------------------------------------
+// Basic Tests for the UnrolledSeq implementation of Sequence
+//----------------------------------------------------------------------
+
+TEST(BasicUnrolledSeqTests, InsertEraseCheck)
+{
+  // small nodes so that splits and merges happen often
+  UnrolledSeq<string, 4> s;
+  ArraySeq<string> expected;
+  for (int i = 0; i < 200; ++i) {
+    int index = (i * 37) % (expected.size() + 1);
+    s.insert(to_string(i), index);
+    expected.insert(to_string(i), index);
+  }
+  for (int i = 0; i < 150; ++i) {
+    int index = (i * 53) % expected.size();
+    s.erase(index);
+    expected.erase(index);
+  }
+  ASSERT_EQ(expected.size(), s.size());
+  for (int i = 0; i < expected.size(); ++i)
+    ASSERT_EQ(expected[i], s[i]);
+  EXPECT_THROW(s[expected.size()], std::out_of_range);
+  EXPECT_THROW(s.insert("x", expected.size() + 1), std::out_of_range);
+}
+
+TEST(BasicUnrolledSeqTests, EraseIteratorCheck)
+{
+  UnrolledSeq<int, 8> s;
+  for (int i = 0; i < 100; ++i)
+    s.insert(i, s.size());
+  for (auto it = s.begin(); it != s.end(); ) {
+    if (*it % 3 != 0)
+      it = s.erase(it);
+    else
+      ++it;
+  }
+  ASSERT_EQ(34, s.size());
+  int expected = 0;
+  for (int x : s) {
+    ASSERT_EQ(expected, x);
+    expected += 3;
+  }
+  ASSERT_EQ(true, s.contains(99));
+  ASSERT_EQ(false, s.contains(98));
+}
+
+TEST(BasicUnrolledSeqTests, CopySortCheck)
+{
+  UnrolledSeq<int> s;
+  for (int i = 0; i < 1000; ++i)
+    s.insert((i * 7919) % 1000, s.size() / 2);
+  UnrolledSeq<int> t = s;
+  t.sort();
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_EQ(i, t[i]);
+  ASSERT_EQ(1000, s.size());
+  UnrolledSeq<int> u = std::move(s);
+  ASSERT_EQ(0, s.size());
+  ASSERT_EQ(1000, u.size());
+}
+
+
+//----------------------------------------------------------------------
+// Basic Tests for the TieredSeq implementation of Sequence
+//----------------------------------------------------------------------
+
+TEST(BasicTieredSeqTests, InsertEraseCheck)
+{
+  // enough elements to widen the chunks a few times
+  TieredSeq<string> s;
+  ArraySeq<string> expected;
+  for (int i = 0; i < 3000; ++i) {
+    int index = (i * 37) % (expected.size() + 1);
+    s.insert(to_string(i), index);
+    expected.insert(to_string(i), index);
+  }
+  for (int i = 0; i < 2500; ++i) {
+    int index = (i * 53) % expected.size();
+    s.erase(index);
+    expected.erase(index);
+  }
+  ASSERT_EQ(expected.size(), s.size());
+  for (int i = 0; i < expected.size(); ++i)
+    ASSERT_EQ(expected[i], s[i]);
+  EXPECT_THROW(s[expected.size()], std::out_of_range);
+  EXPECT_THROW(s.erase(-1), std::out_of_range);
+}
+
+TEST(BasicTieredSeqTests, CopySortCheck)
+{
+  TieredSeq<int> s;
+  for (int i = 0; i < 1000; ++i)
+    s.insert((i * 7919) % 1000, s.size() / 2);
+  TieredSeq<int> t = s;
+  t.sort();
+  int expected = 0;
+  for (int x : t)
+    ASSERT_EQ(expected++, x);
+  ASSERT_EQ(true, s.contains(999));
+  TieredSeq<int> u = std::move(s);
+  ASSERT_EQ(0, s.size());
+  ASSERT_EQ(1000, u.size());
+  ASSERT_EQ(t.size(), u.size());
+}
+
+TEST(BasicTieredSeqTests, BinSearchMapCheck)
+{
+  BinSearchMap<int,string,TieredSeq> m;
+  for (int i = 0; i < 1000; ++i)
+    m.insert((i * 7919) % 1000, to_string(i));
+  for (int k = 0; k < 1000; k += 2)
+    m.erase(k);
+  ASSERT_EQ(500, m.size());
+  ASSERT_EQ(false, m.contains(500));
+  ASSERT_EQ("1", m[919]);
+  ASSERT_EQ(true, m.try_emplace(500, "x"));
+  ArraySeq<int> keys = m.find_keys(499, 503);
+  ASSERT_EQ(4, keys.size());
+  ASSERT_EQ(499, keys[0]);
+  ASSERT_EQ(500, keys[1]);
+  ArraySeq<int> sorted = m.sorted_keys();
+  ASSERT_EQ(501, sorted.size());
+  ASSERT_EQ(500, sorted[250]);
+  ASSERT_EQ(501, sorted[251]);
+}
+
+
+//----------------------------------------------------------------------
+// Basic Tests for the GapSeq implementation of Sequence
+//----------------------------------------------------------------------
+
+TEST(BasicGapSeqTests, InsertEraseCheck)
+{
+  GapSeq<string> s;
+  ArraySeq<string> expected;
+  // runs of nearby edits with jumps between them
+  for (int i = 0; i < 500; ++i) {
+    int index = i % 10 == 0 ? (i * 37) % (expected.size() + 1)
+                            : std::min(expected.size(), 3);
+    s.insert(to_string(i), index);
+    expected.insert(to_string(i), index);
+  }
+  for (int i = 0; i < 400; ++i) {
+    int index = (i * 53) % expected.size();
+    s.erase(index);
+    expected.erase(index);
+  }
+  ASSERT_EQ(expected.size(), s.size());
+  for (int i = 0; i < expected.size(); ++i)
+    ASSERT_EQ(expected[i], s[i]);
+  ASSERT_EQ(true, s.contains(expected[50]));
+  ASSERT_EQ(false, s.contains("none"));
+  EXPECT_THROW(s[expected.size()], std::out_of_range);
+  EXPECT_THROW(s.insert("x", -1), std::out_of_range);
+}
+
+TEST(BasicGapSeqTests, FullEraseCheck)
+{
+  // a copy is reserved to exactly its size, so its gap is empty
+  GapSeq<string> s;
+  for (int i = 0; i < 10; ++i)
+    s.insert(to_string(i), i);
+  GapSeq<string> t = s;
+  t.erase(1);
+  t.erase(8);
+  t.erase(0);
+  ASSERT_EQ(7, t.size());
+  for (int i = 0; i < 7; ++i)
+    ASSERT_EQ(to_string(i + 2), t[i]);
+  BinSearchMap<string,int,GapSeq> m;
+  for (int i = 0; i < 10; ++i)
+    m.insert(to_string(i), i);
+  BinSearchMap<string,int,GapSeq> copy = m;
+  copy.erase("3");
+  ASSERT_EQ(9, copy.size());
+  ASSERT_EQ(false, copy.contains("3"));
+  ASSERT_EQ(9, copy["9"]);
+}
+
+TEST(BasicGapSeqTests, CopySortCheck)
+{
+  GapSeq<int> s;
+  for (int i = 0; i < 1000; ++i)
+    s.insert((i * 7919) % 1000, s.size() / 2);
+  GapSeq<int> t = s;
+  ASSERT_EQ(s[3], *(3 + t.begin()));
+  t.sort();
+  int expected = 0;
+  for (int x : t)
+    ASSERT_EQ(expected++, x);
+  ASSERT_EQ(true, s.contains(999));
+  GapSeq<int> u = std::move(s);
+  ASSERT_EQ(0, s.size());
+  ASSERT_EQ(1000, u.size());
+}
+
+TEST(BasicGapSeqTests, BinSearchMapCheck)
+{
+  BinSearchMap<int,string,GapSeq> m;
+  for (int i = 0; i < 1000; ++i)
+    m.insert((i * 7919) % 1000, to_string(i));
+  for (int k = 0; k < 1000; k += 2)
+    m.erase(k);
+  ASSERT_EQ(500, m.size());
+  ASSERT_EQ(false, m.contains(500));
+  ASSERT_EQ("1", m[919]);
+  ArraySeq<int> keys = m.find_keys(498, 503);
+  ASSERT_EQ(3, keys.size());
+  ASSERT_EQ(499, keys[0]);
+  ASSERT_EQ(999, m.sorted_keys()[499]);
+}
+
+
+//----------------------------------------------------------------------
+// Basic Tests for the RingSeq implementation of Sequence
+//----------------------------------------------------------------------
+
+TEST(BasicRingSeqTests, InsertEraseCheck)
+{
+  RingSeq<string> s;
+  ArraySeq<string> expected;
+  // mostly at the ends (wrapping around the array), some in the middle
+  for (int i = 0; i < 500; ++i) {
+    int index = i % 3 == 0 ? 0 : i % 3 == 1 ? expected.size()
+                                            : (i * 37) % (expected.size() + 1);
+    s.insert(to_string(i), index);
+    expected.insert(to_string(i), index);
+  }
+  for (int i = 0; i < 400; ++i) {
+    int index = i % 2 == 0 ? 0 : (i * 53) % expected.size();
+    s.erase(index);
+    expected.erase(index);
+  }
+  ASSERT_EQ(expected.size(), s.size());
+  for (int i = 0; i < expected.size(); ++i)
+    ASSERT_EQ(expected[i], s[i]);
+  ASSERT_EQ(true, s.contains(expected[50]));
+  EXPECT_THROW(s[expected.size()], std::out_of_range);
+  EXPECT_THROW(s.erase(expected.size()), std::out_of_range);
+}
+
+TEST(BasicRingSeqTests, BitwiseShiftCheck)
+{
+  // ints are shifted with memmove, in runs split where they wrap
+  RingSeq<int> s;
+  ArraySeq<int> expected;
+  for (int i = 0; i < 300; ++i) {
+    int index = i % 4 == 0 ? 0 : (i * 31) % (expected.size() + 1);
+    s.insert(i, index);
+    expected.insert(i, index);
+  }
+  for (int i = 0; i < 250; ++i) {
+    int index = (i * 17) % expected.size();
+    s.erase(index);
+    expected.erase(index);
+  }
+  ASSERT_EQ(expected.size(), s.size());
+  for (int i = 0; i < expected.size(); ++i)
+    ASSERT_EQ(expected[i], s[i]);
+}
+
+TEST(BasicRingSeqTests, CopySortCheck)
+{
+  RingSeq<int> s;
+  for (int i = 0; i < 1000; ++i)
+    s.insert((i * 7919) % 1000, i % 2 == 0 ? 0 : s.size());
+  RingSeq<int> t = s;
+  t.sort();
+  int expected = 0;
+  for (int x : t)
+    ASSERT_EQ(expected++, x);
+  RingSeq<int> u = std::move(s);
+  ASSERT_EQ(0, s.size());
+  ASSERT_EQ(1000, u.size());
+  ASSERT_EQ(true, u.contains(999));
+}
+
+TEST(BasicRingSeqTests, BinSearchMapCheck)
+{
+  BinSearchMap<int,string,RingSeq> m;
+  for (int k = 1000; k > 0; --k)
+    m.insert(k, to_string(k));
+  for (int k = 1; k <= 500; ++k)
+    m.erase(k);
+  ASSERT_EQ(500, m.size());
+  ASSERT_EQ(false, m.contains(500));
+  ASSERT_EQ("501", m[501]);
+  ASSERT_EQ(501, m.sorted_keys()[0]);
+  ASSERT_EQ(3, m.find_keys(0, 503).size());
+}
 
 
 //----------------------------------------------------------------------
@@ -0,0 +1,63 @@
+//---------------------------------------------------------------------------
+// NAME: Mason Manca
+// FILE: indexiterator.h
+// DATE: Fall 2021
+// DESC: Random access iterator for sequences whose elements are not
+//       contiguous but can be reached by index in O(1) (through
+//       at_unchecked). The iterator is a sequence pointer and an
+//       index.
+//---------------------------------------------------------------------------
+
+#ifndef INDEXITERATOR_H
+#define INDEXITERATOR_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+
+template<typename SeqPtr, typename Ref>
+class IndexIterator
+{
+public:
+
+  using value_type = typename std::decay<Ref>::type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = typename std::remove_reference<Ref>::type*;
+  using reference = Ref;
+  using iterator_category = std::random_access_iterator_tag;
+
+  IndexIterator() = default;
+  IndexIterator(SeqPtr seq, int index) : seq(seq), index(index) {}
+
+  reference operator*() const { return seq->at_unchecked(index); }
+  pointer operator->() const { return &seq->at_unchecked(index); }
+  reference operator[](difference_type n) const { return seq->at_unchecked(index + n); }
+
+  IndexIterator& operator++() { ++index; return *this; }
+  IndexIterator operator++(int) { IndexIterator tmp = *this; ++index; return tmp; }
+  IndexIterator& operator--() { --index; return *this; }
+  IndexIterator operator--(int) { IndexIterator tmp = *this; --index; return tmp; }
+  IndexIterator& operator+=(difference_type n) { index += n; return *this; }
+  IndexIterator& operator-=(difference_type n) { index -= n; return *this; }
+  IndexIterator operator+(difference_type n) const { return IndexIterator(seq, index + n); }
+  IndexIterator operator-(difference_type n) const { return IndexIterator(seq, index - n); }
+  friend IndexIterator operator+(difference_type n, const IndexIterator& it) { return it + n; }
+  difference_type operator-(const IndexIterator& rhs) const { return index - rhs.index; }
+
+  bool operator==(const IndexIterator& rhs) const { return index == rhs.index; }
+  bool operator!=(const IndexIterator& rhs) const { return index != rhs.index; }
+  bool operator<(const IndexIterator& rhs) const { return index < rhs.index; }
+  bool operator>(const IndexIterator& rhs) const { return index > rhs.index; }
+  bool operator<=(const IndexIterator& rhs) const { return index <= rhs.index; }
+  bool operator>=(const IndexIterator& rhs) const { return index >= rhs.index; }
+
+private:
+
+  // sequence and current index
+  SeqPtr seq = nullptr;
+  int index = 0;
+};
+
+
+#endif
@@ -0,0 +1,74 @@
+//---------------------------------------------------------------------------
+// NAME: Mason Manca
+// FILE: interface.h
+// DATE: Fall 2021
+// DESC: Compile-time versions of the Sequence and Map interfaces. A
+//       type satisfies is_sequence / is_map if it provides the same
+//       member functions as the abstract classes, whether or not it
+//       derives from them. Generic code (templated on the concrete
+//       type) checks these with static_assert and then calls the
+//       members directly. The concrete classes are final, so those
+//       calls bind statically and can be inlined, while the same
+//       objects still work through a runtime Sequence& or Map&.
+//---------------------------------------------------------------------------
+
+#ifndef INTERFACE_H
+#define INTERFACE_H
+
+#include <type_traits>
+#include <utility>
+
+template<typename T>
+class ArraySeq;
+
+
+//----------------------------------------------------------------------
+// True if S provides the Sequence<T> member functions
+//----------------------------------------------------------------------
+template<typename S, typename T, typename = void>
+struct is_sequence : std::false_type {};
+
+template<typename S, typename T>
+struct is_sequence<S, T, std::void_t<
+  decltype(int(std::declval<const S&>().size())),
+  decltype(bool(std::declval<const S&>().empty())),
+  decltype(static_cast<T&>(std::declval<S&>()[0])),
+  decltype(static_cast<const T&>(std::declval<const S&>()[0])),
+  decltype(std::declval<S&>().insert(std::declval<const T&>(), 0)),
+  decltype(std::declval<S&>().erase(0)),
+  decltype(bool(std::declval<const S&>().contains(std::declval<const T&>()))),
+  decltype(std::declval<S&>().sort())>> : std::true_type {};
+
+
+//----------------------------------------------------------------------
+// True if M provides the Map<K,V> member functions
+//----------------------------------------------------------------------
+template<typename M, typename K, typename V, typename = void>
+struct is_map : std::false_type {};
+
+template<typename M, typename K, typename V>
+struct is_map<M, K, V, std::void_t<
+  decltype(int(std::declval<const M&>().size())),
+  decltype(bool(std::declval<const M&>().empty())),
+  decltype(static_cast<V&>(std::declval<M&>()[std::declval<const K&>()])),
+  decltype(static_cast<const V&>(std::declval<const M&>()[std::declval<const K&>()])),
+  decltype(std::declval<M&>().insert(std::declval<const K&>(), std::declval<const V&>())),
+  decltype(std::declval<M&>().erase(std::declval<const K&>())),
+  decltype(bool(std::declval<const M&>().contains(std::declval<const K&>()))),
+  decltype(static_cast<ArraySeq<K>>(
+    std::declval<const M&>().find_keys(std::declval<const K&>(), std::declval<const K&>()))),
+  decltype(static_cast<ArraySeq<K>>(std::declval<const M&>().sorted_keys()))>>
+  : std::true_type {};
+
+
+//----------------------------------------------------------------------
+// True if member calls on a T (known statically) bind without virtual
+// dispatch: T is either not polymorphic or is final
+//----------------------------------------------------------------------
+template<typename T>
+struct has_static_dispatch
+  : std::integral_constant<bool, !std::is_polymorphic<T>::value or
+                                 std::is_final<T>::value> {};
+
+
+#endif
@@ -0,0 +1,171 @@
+//---------------------------------------------------------------------------
+// NAME: Mason Manca
+// FILE: keyview.h
+// DATE: Fall 2021
+// DESC: A non-owning, read-only view of keys stored at a fixed byte
+//       stride in contiguous memory (for example the first members
+//       of an array of key-value pairs). A view is a pointer, a
+//       length, and a stride, so it is cheap to create and copy. It
+//       is only valid until the storage it refers to is modified;
+//       to_seq() copies the keys into an ArraySeq when they must
+//       outlive that.
+//---------------------------------------------------------------------------
+
+#ifndef KEYVIEW_H
+#define KEYVIEW_H
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include "arrayseq.h"
+
+
+template<typename K>
+class KeyView
+{
+public:
+
+  // Random access iterator stepping stride bytes per key
+  class Iterator
+  {
+  public:
+
+    using value_type = K;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const K*;
+    using reference = const K&;
+    using iterator_category = std::random_access_iterator_tag;
+
+    Iterator() = default;
+    Iterator(const char* ptr, std::ptrdiff_t stride) : ptr(ptr), stride(stride) {}
+
+    reference operator*() const { return *reinterpret_cast<const K*>(ptr); }
+    pointer operator->() const { return reinterpret_cast<const K*>(ptr); }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    Iterator& operator++() { ptr += stride; return *this; }
+    Iterator operator++(int) { Iterator tmp = *this; ptr += stride; return tmp; }
+    Iterator& operator--() { ptr -= stride; return *this; }
+    Iterator operator--(int) { Iterator tmp = *this; ptr -= stride; return tmp; }
+    Iterator& operator+=(difference_type n) { ptr += n * stride; return *this; }
+    Iterator& operator-=(difference_type n) { ptr -= n * stride; return *this; }
+    Iterator operator+(difference_type n) const { return Iterator(ptr + n * stride, stride); }
+    Iterator operator-(difference_type n) const { return Iterator(ptr - n * stride, stride); }
+    friend Iterator operator+(difference_type n, const Iterator& it) { return it + n; }
+    difference_type operator-(const Iterator& rhs) const { return (ptr - rhs.ptr) / stride; }
+
+    bool operator==(const Iterator& rhs) const { return ptr == rhs.ptr; }
+    bool operator!=(const Iterator& rhs) const { return ptr != rhs.ptr; }
+    bool operator<(const Iterator& rhs) const { return ptr < rhs.ptr; }
+    bool operator>(const Iterator& rhs) const { return ptr > rhs.ptr; }
+    bool operator<=(const Iterator& rhs) const { return ptr <= rhs.ptr; }
+    bool operator>=(const Iterator& rhs) const { return ptr >= rhs.ptr; }
+
+  private:
+
+    // current key (as bytes, so the stride can be any struct size)
+    const char* ptr = nullptr;
+
+    // bytes between consecutive keys
+    std::ptrdiff_t stride = sizeof(K);
+  };
+
+  // Creates an empty view
+  KeyView() = default;
+
+  // Creates a view of n keys starting at first, each stride bytes
+  // after the previous one
+  KeyView(const K* first, int n, std::ptrdiff_t stride = sizeof(K));
+
+  // Returns the number of keys in the view
+  int size() const;
+
+  // Tests if the view is empty
+  bool empty() const;
+
+  // Returns the key at the index. Throws out_of_range if index is
+  // invalid.
+  const K& operator[](int index) const;
+
+  // Returns the key at the index without checking the index
+  const K& at_unchecked(int index) const;
+
+  // Iterators over the keys
+  Iterator begin() const;
+  Iterator end() const;
+
+  // Copies the keys into a new sequence
+  ArraySeq<K> to_seq() const;
+
+private:
+
+  // first key
+  const char* first = nullptr;
+
+  // number of keys
+  int count = 0;
+
+  // bytes between consecutive keys
+  std::ptrdiff_t stride = sizeof(K);
+};
+
+
+// Creates a view of n keys starting at first
+template<typename K>
+KeyView<K>::KeyView(const K* first, int n, std::ptrdiff_t stride)
+  : first(reinterpret_cast<const char*>(first)), count(n), stride(stride)
+{
+}
+
+// Returns the number of keys in the view
+template<typename K>
+int KeyView<K>::size() const
+{
+  return count;
+}
+
+// Tests if the view is empty
+template<typename K>
+bool KeyView<K>::empty() const
+{
+  return count == 0;
+}
+
+// Returns the key at the index, throws out_of_range if invalid
+template<typename K>
+const K& KeyView<K>::operator[](int index) const
+{
+  if(index >= count or index < 0)
+    throw std::out_of_range("Out of range in KeyView []");
+  return at_unchecked(index);
+}
+
+// Returns the key at the index without checking the index
+template<typename K>
+const K& KeyView<K>::at_unchecked(int index) const
+{
+  return *reinterpret_cast<const K*>(first + index * stride);
+}
+
+// Iterators over the keys
+template<typename K>
+typename KeyView<K>::Iterator KeyView<K>::begin() const
+{
+  return Iterator(first, stride);
+}
+
+template<typename K>
+typename KeyView<K>::Iterator KeyView<K>::end() const
+{
+  return Iterator(first + count * stride, stride);
+}
+
+// Copies the keys into a new sequence (allocating once)
+template<typename K>
+ArraySeq<K> KeyView<K>::to_seq() const
+{
+  return ArraySeq<K>(begin(), end());
+}
+
+
+#endif
@@ -7,11 +7,17 @@
 #ifndef LINKEDMAP_H
 #define LINKEDMAP_H
 
+#include <tuple>
+#include <utility>
 #include "map.h"
+#include "interface.h"
 #include "linkedseq.h"
 
-template <typename K, typename V>
-class LinkedMap : public Map<K, V>
+// Seq is the linked sequence holding the pairs (LinkedSeq, or
+// UnrolledSeq64 for UnrolledMap). It must provide forward iterators and
+// an erase(iterator) that removes in place.
+template <typename K, typename V, template <typename> class Seq = LinkedSeq>
+class LinkedMap final : public Map<K, V>
 {
 public:
     // Returns the number of key-value pairs in the map
@@ -33,6 +39,19 @@ public:
     // collection. Insert does not check if the key is present.
     void insert(const K &key, const V &value);
 
+    // Same as above, moving the key and value into the collection
+    // instead of copying them.
+    void insert(K &&key, V &&value);
+
+    // Adds the key with a value constructed in place from the
+    // arguments (forwarded to V's constructor) if the key is not
+    // already in the collection. Returns true if the pair was added,
+    // and false (without using the arguments) otherwise.
+    template <typename... Args>
+    bool try_emplace(const K &key, Args &&...args);
+    template <typename... Args>
+    bool try_emplace(K &&key, Args &&...args);
+
     // Shrinks the collection by removing the key-value pair with the
     // given key. Does not modify the collection if the collection does
     // not contain the key. Throws out_of_range if the given key is not
@@ -53,8 +72,12 @@ public:
     ArraySeq<K> sorted_keys() const;
 
 private:
+    // helper for both try_emplace overloads (KArg is const K& or K)
+    template <typename KArg, typename... Args>
+    bool emplace_unique(KArg &&key, Args &&...args);
+
     // implemented as a linked list of (key-value) pairs
-    LinkedSeq<std::pair<K, V>> seq;
+    Seq<std::pair<K, V>> seq;
 };
 
 // TODO: Implement the LinkedMap functions below. Note that you do not
@@ -63,143 +86,163 @@ private:
 //       move assignment operator for this version of Map. Instead,
 //       the default C++ implementations are sufficient.
 
-#endif
 
 // Returns the number of key-value pairs in the map
 
-template <typename K, typename V>
-int LinkedMap<K, V>::size() const
+template <typename K, typename V, template <typename> class Seq>
+int LinkedMap<K, V, Seq>::size() const
 {
     return seq.size();
 }
 
 // Tests if the map is empty
-template <typename K, typename V>
-bool LinkedMap<K, V>::empty() const
+template <typename K, typename V, template <typename> class Seq>
+bool LinkedMap<K, V, Seq>::empty() const
 {
     return seq.empty();
 }
 
 // Allows values associated with a key to be updated. Throws
 // out_of_range if the given key is not in the collection.
-template <typename K, typename V>
-V &LinkedMap<K, V>::operator[](const K &key)
+template <typename K, typename V, template <typename> class Seq>
+V &LinkedMap<K, V, Seq>::operator[](const K &key)
 {
-    if (contains(key))
+    for (std::pair<K, V> &p : seq)
     {
-        for (int i = 0; i < seq.size(); ++i)
-        {
-            if (seq[i].first == key)
-                return seq[i].second;
-        }
-    }
-    else
-    {
-        throw std::out_of_range("Out of range in the [] nonconst");
+        if (p.first == key)
+            return p.second;
     }
+    throw std::out_of_range("Out of range in the [] nonconst");
 }
 
 // Returns the value for a given key. Throws out_of_range if the
 // given key is not in the collection.
-template <typename K, typename V>
-const V &LinkedMap<K, V>::operator[](const K &key) const
+template <typename K, typename V, template <typename> class Seq>
+const V &LinkedMap<K, V, Seq>::operator[](const K &key) const
 {
-    if (contains(key))
+    for (const std::pair<K, V> &p : seq)
     {
-        for (int i = 0; i < seq.size(); ++i)
-        {
-            if (seq[i].first == key)
-                return seq[i].second;
-        }
-    }
-    else
-    {
-        throw std::out_of_range("Out of range in the [] nonconst");
+        if (p.first == key)
+            return p.second;
     }
+    throw std::out_of_range("Out of range in the [] const");
 }
 
 // Extends the collection by adding the given key-value
 // pair. Assumes the key being added is not present in the
 // collection. Insert does not check if the key is present.
-template <typename K, typename V>
-void LinkedMap<K, V>::insert(const K &key, const V &value)
+template <typename K, typename V, template <typename> class Seq>
+void LinkedMap<K, V, Seq>::insert(const K &key, const V &value)
 {
     seq.insert({key, value}, seq.size());
 }
 
+// Extends the collection by moving the given key-value pair in.
+// Assumes the key being added is not present in the collection.
+template <typename K, typename V, template <typename> class Seq>
+void LinkedMap<K, V, Seq>::insert(K &&key, V &&value)
+{
+    seq.insert({std::move(key), std::move(value)}, seq.size());
+}
+
+// Adds the key with a value constructed in place from the arguments
+// if the key is not already in the collection.
+template <typename K, typename V, template <typename> class Seq>
+template <typename... Args>
+bool LinkedMap<K, V, Seq>::try_emplace(const K &key, Args &&...args)
+{
+    return emplace_unique(key, std::forward<Args>(args)...);
+}
+
+template <typename K, typename V, template <typename> class Seq>
+template <typename... Args>
+bool LinkedMap<K, V, Seq>::try_emplace(K &&key, Args &&...args)
+{
+    return emplace_unique(std::move(key), std::forward<Args>(args)...);
+}
+
+// Returns false if the key is in the collection, otherwise adds the
+// key (forwarded) with a value constructed from the arguments.
+template <typename K, typename V, template <typename> class Seq>
+template <typename KArg, typename... Args>
+bool LinkedMap<K, V, Seq>::emplace_unique(KArg &&key, Args &&...args)
+{
+    if (contains(key))
+        return false;
+    seq.insert(std::pair<K, V>(std::piecewise_construct,
+                               std::forward_as_tuple(std::forward<KArg>(key)),
+                               std::forward_as_tuple(std::forward<Args>(args)...)),
+               seq.size());
+    return true;
+}
+
 // Shrinks the collection by removing the key-value pair with the
 // given key. Does not modify the collection if the collection does
 // not contain the key. Throws out_of_range if the given key is not
 // in the collection.
-template <typename K, typename V>
-void LinkedMap<K, V>::erase(const K &key)
+template <typename K, typename V, template <typename> class Seq>
+void LinkedMap<K, V, Seq>::erase(const K &key)
 {
-    if (contains(key))
+    // one pass: the matching node is unlinked where it is found
+    for (auto it = seq.begin(); it != seq.end(); ++it)
     {
-        int index = -1;
-        for (int i = 0; i < seq.size(); ++i)
+        if (it->first == key)
         {
-            if (seq[i].first == key)
-            {
-                index = i;
-                break;
-            }
+            seq.erase(it);
+            return;
         }
-        seq.erase(index);
-    }
-    else
-    {
-        throw std::out_of_range("Out of range in the [] nonconst");
     }
+    throw std::out_of_range("Out of range in erase");
 }
 
 // Returns true if the key is in the collection, and false
 // otherwise.
-template <typename K, typename V>
-bool LinkedMap<K, V>::contains(const K &key) const
+template <typename K, typename V, template <typename> class Seq>
+bool LinkedMap<K, V, Seq>::contains(const K &key) const
 {
-    for (int i = 0; i < seq.size(); ++i)
+    for (const std::pair<K, V> &p : seq)
     {
-        if (seq[i].first == key)
+        if (p.first == key)
             return true;
     }
     return false;
 }
 
 // Returns the keys k in the collection such that k1 <= k <= k2
-template <typename K, typename V>
-ArraySeq<K> LinkedMap<K, V>::find_keys(const K &k1, const K &k2) const
+template <typename K, typename V, template <typename> class Seq>
+ArraySeq<K> LinkedMap<K, V, Seq>::find_keys(const K &k1, const K &k2) const
 {
     ArraySeq<K> new_seq;
-    ArraySeq<K> keys = all_keys();
-    for (int i = 0; i < keys.size(); ++i)
+    for (const std::pair<K, V> &p : seq)
     {
-        if (keys[i] >= k1 && keys[i] <= k2)
-            new_seq.insert(keys[i], new_seq.size());
+        if (p.first >= k1 && p.first <= k2)
+            new_seq.insert(p.first, new_seq.size());
     }
     return new_seq;
 }
 
 // Returns all the keys in the collection
-template <typename K, typename V>
-ArraySeq<K> LinkedMap<K, V>::all_keys() const
+template <typename K, typename V, template <typename> class Seq>
+ArraySeq<K> LinkedMap<K, V, Seq>::all_keys() const
 {
-    ArraySeq<K> new_seq;
-    for (int i = 0; i < seq.size(); ++i)
-        new_seq.insert(seq[i].first, new_seq.size());
-
-    return new_seq;
+    return ArraySeq<K>(KeyIterator(seq.begin()), KeyIterator(seq.end()));
 }
 
 // Returns the keys in the collection in ascending sorted order.
-template <typename K, typename V>
-ArraySeq<K> LinkedMap<K, V>::sorted_keys() const
+template <typename K, typename V, template <typename> class Seq>
+ArraySeq<K> LinkedMap<K, V, Seq>::sorted_keys() const
 {
-    ArraySeq<K> new_seq;
-
-    for (int i = 0; i < seq.size(); ++i)
-        new_seq.insert(seq[i].first, new_seq.size());
-        
-    new_seq.merge_sort();
+    ArraySeq<K> new_seq = all_keys();
+    // integer keys are radix sorted, anything else is merge sorted
+    if constexpr (radix_traits<K>::sortable)
+        new_seq.sort();
+    else
+        new_seq.parallel_merge_sort();
     return new_seq;
-}
\ No newline at end of file
+}
+
+static_assert(is_map<LinkedMap<int, int>, int, int>::value and
+              has_static_dispatch<LinkedMap<int, int>>::value,
+              "LinkedMap must satisfy the Map interface statically");
+
+#endif
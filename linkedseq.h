@@ -1,354 +1,521 @@
-
 //---------------------------------------------------------------------------
 // NAME: Mason Manca
-// FILE: arrayseq.h
+// FILE: linkedseq.h
 // DATE: Fall 2021
-// DESC: Expanding Array
-//----------------------------------------------------------------------
-
+// DESC: Doubly linked list implementation of Sequence. Nodes come
+//       from a node allocator (NodePool by default, see nodepool.h),
+//       so adding and removing at either end is O(1) without a heap
+//       allocation per node. Index based access walks from whichever
+//       end of the list is closer.
+//---------------------------------------------------------------------------
 
-#ifndef ARRAYLIST_H
-#define ARRAYLIST_H
+#ifndef LINKEDSEQ_H
+#define LINKEDSEQ_H
 
 #include <stdexcept>
 #include <ostream>
-#include <random>
-#include <iostream>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
 #include "sequence.h"
+#include "nodepool.h"
+#include "interface.h"
 
 
-template<typename T>
-class ArraySeq : public Sequence<T>
+template<typename T, template<typename> class NodeAlloc = NodePool>
+class LinkedSeq final : public Sequence<T>
 {
+private:
+
+  // list node holding one element
+  struct Node
+  {
+    T value;
+    Node* prev;
+    Node* next;
+  };
+
 public:
 
+  // Forward iterator over the elements (from head to tail)
+  template<typename Ref>
+  class Iterator
+  {
+  public:
+
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = typename std::remove_reference<Ref>::type*;
+    using reference = Ref;
+    using iterator_category = std::forward_iterator_tag;
+
+    Iterator() = default;
+    explicit Iterator(Node* node) : node(node) {}
+
+    reference operator*() const { return node->value; }
+    pointer operator->() const { return &node->value; }
+
+    Iterator& operator++() { node = node->next; return *this; }
+    Iterator operator++(int) { Iterator tmp = *this; node = node->next; return tmp; }
+
+    bool operator==(const Iterator& rhs) const { return node == rhs.node; }
+    bool operator!=(const Iterator& rhs) const { return node != rhs.node; }
+
+  private:
+
+    // the sequence unlinks nodes through iterators (erase)
+    friend class LinkedSeq;
+
+    // current node (nullptr past the tail)
+    Node* node = nullptr;
+  };
+
+  using iterator = Iterator<T&>;
+  using const_iterator = Iterator<const T&>;
+
   // Default constructor
-  
-  ArraySeq();
+  LinkedSeq();
 
   // Copy constructor
-  ArraySeq(const ArraySeq& rhs);
+  LinkedSeq(const LinkedSeq& rhs);
 
   // Move constructor
-  ArraySeq(ArraySeq&& rhs);
+  LinkedSeq(LinkedSeq&& rhs);
 
   // Copy assignment operator
-  ArraySeq& operator=(const ArraySeq& rhs);
+  LinkedSeq& operator=(const LinkedSeq& rhs);
 
   // Move assignment operator
-  ArraySeq& operator=(ArraySeq&& rhs);
-  
+  LinkedSeq& operator=(LinkedSeq&& rhs);
+
   // Destructor
-  virtual ~ArraySeq();
-  
+  ~LinkedSeq();
+
   // Returns the number of elements in the sequence
-  virtual int size() const;
+  int size() const;
 
   // Tests if the sequence is empty
-  virtual bool empty() const;
+  bool empty() const;
 
   // Returns a reference to the element at the index in the
   // sequence. Throws out_of_range if index is invalid.
-  virtual T& operator[](int index);
+  T& operator[](int index);
 
   // Returns a constant address to the element at the index in the
   // sequence. Throws out_of_range if index is invalid.
-  virtual const T& operator[](int index) const;
+  const T& operator[](int index) const;
 
   // Extends the sequence by inserting the element at the given
   // index. Throws out_of_range if the index is invalid.
-  virtual void insert(const T& elem, int index);
+  void insert(const T& elem, int index);
+
+  // Same as above, moving the element into the sequence instead of
+  // copying it.
+  void insert(T&& elem, int index);
+
+  // Extends the sequence by constructing an element in place at the
+  // given index from the arguments (forwarded to T's constructor),
+  // and returns a reference to it. Throws out_of_range if the index
+  // is invalid.
+  template<typename... Args>
+  T& emplace(int index, Args&&... args);
 
   // Shrinks the sequence by removing the element at the index in the
   // sequence. Throws out_of_range if index is invalid.
-  virtual void erase(int index);
+  void erase(int index);
+
+  // Removes the element at the iterator (which must refer to an
+  // element of this sequence) in O(1) and returns an iterator to the
+  // element after it.
+  iterator erase(iterator pos);
 
   // Returns true if the element is in the sequence, and false
   // otherwise.
-  virtual bool contains(const T& elem) const;
+  bool contains(const T& elem) const;
+
+  // Preallocates nodes so that the sequence can grow to n elements
+  // without allocating (if the node allocator supports it).
+  void reserve(int n);
 
-  // Sorts the elements in the sequence using less than equal (<=)
-  // operator. (Not implemented in HW-3)
-  virtual void sort(); 
+  // Sorts the elements in the sequence using less than (<) by
+  // relinking the nodes (a stable bottom-up merge sort, O(n log n)
+  // with no allocation).
+  void sort();
 
-  virtual void merge_sort();
+  // Iterators over the elements, for range-for loops
+  iterator begin();
+  iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
 
-  virtual void quick_sort();
-  
 private:
 
-  // resizable array
-  T* array = nullptr;
+  // first and last nodes (nullptr if empty)
+  Node* head = nullptr;
+  Node* tail = nullptr;
 
-  // size of list
-  int count = 0;
+  // number of nodes in the list
+  int node_count = 0;
 
-  // max capacity of the array
-  int capacity = 0;
+  // node storage
+  NodeAlloc<Node> nodes;
 
-  // helper to double the capacity of the array
-  void resize();
-  
-  // helper to delete the array list (called by destructor and copy
-  // constructor)
-  void make_empty();
+  // helper to return the node at the index (which must be valid),
+  // walking from the closer end of the list
+  Node* node_at(int index) const;
 
-  void merge_sort(int start, int end);
+  // helper to unlink the node, destroy its element, and release it
+  void unlink(Node* node);
 
-  void quick_sort(int start, int end);
+  // helper to destroy the elements and release the nodes
+  void make_empty();
 
 };
 
 
-template <typename T>
-ArraySeq<T>::ArraySeq()
+template<typename T, template<typename> class NodeAlloc>
+std::ostream& operator<<(std::ostream& stream, const LinkedSeq<T, NodeAlloc>& seq)
 {
-  array = nullptr;
-  count = 0;
-  capacity = 0;
-}
-// Copy constructor
-template <typename T>
-  ArraySeq<T>::ArraySeq(const ArraySeq& rhs)
+  bool first = true;
+  for(const T& elem : seq)
   {
-    for(int i = 0; i < rhs.size();++i)
-      insert(rhs[i],i);
+    if(not first)
+      stream << ", ";
+    stream << elem;
+    first = false;
   }
+  return stream;
+}
 
-  // Move constructor
-  template <typename T>
-  ArraySeq<T>::ArraySeq(ArraySeq&& rhs)
-  {
-    *this = std::move(rhs);
-  }
 
-  // Copy assignment operator
-  template <typename T>
-  ArraySeq<T> &ArraySeq<T>::operator=(const ArraySeq& rhs)
-  {
-    if(this != &rhs)
-      {
-        make_empty();
-        if(!rhs.empty())
-          {
-            for(int i = 0; i < rhs.size(); i++)
-              insert(rhs[i], i);
-          }
-      }
-    return *this;
-  }
+// Default constructor
+template<typename T, template<typename> class NodeAlloc>
+LinkedSeq<T, NodeAlloc>::LinkedSeq()
+{
+}
 
-  // Move assignment operator
-  template <typename T>
-  ArraySeq<T> &ArraySeq<T>::operator=(ArraySeq&& rhs)
-  {
-    if (this != &rhs)
-    {
-        make_empty();
-        count = rhs.count;
-        capacity = rhs.capacity;
-        array = rhs.array;
-        rhs.make_empty();
-        rhs.array = nullptr;
-    }
+// Copy constructor
+template<typename T, template<typename> class NodeAlloc>
+LinkedSeq<T, NodeAlloc>::LinkedSeq(const LinkedSeq& rhs)
+{
+  *this = rhs;
+}
 
-    return *this;
-  }
-  
-  // Destructor
-  template <typename T>
-  ArraySeq<T>::~ArraySeq()
+// Move constructor
+template<typename T, template<typename> class NodeAlloc>
+LinkedSeq<T, NodeAlloc>::LinkedSeq(LinkedSeq&& rhs)
+{
+  *this = std::move(rhs);
+}
+
+// Copy assignment operator
+template<typename T, template<typename> class NodeAlloc>
+LinkedSeq<T, NodeAlloc>& LinkedSeq<T, NodeAlloc>::operator=(const LinkedSeq& rhs)
+{
+  if(this != &rhs)
   {
     make_empty();
-    delete [] array;
-  }
-  
-  // Returns the number of elements in the sequence
-  template <typename T>
-  int ArraySeq<T>::size() const
-  {
-    return count;
+    nodes.reserve(rhs.node_count);
+    for(const T& elem : rhs)
+      emplace(node_count, elem);
   }
+  return *this;
+}
 
-  // Tests if the sequence is empty
-  template <typename T>
-  bool ArraySeq<T>::empty() const
+// Move assignment operator
+template<typename T, template<typename> class NodeAlloc>
+LinkedSeq<T, NodeAlloc>& LinkedSeq<T, NodeAlloc>::operator=(LinkedSeq&& rhs)
+{
+  if(this != &rhs)
   {
-    return(count == 0);
+    make_empty();
+    // the nodes move with their allocator
+    nodes = std::move(rhs.nodes);
+    head = rhs.head;
+    tail = rhs.tail;
+    node_count = rhs.node_count;
+    rhs.head = rhs.tail = nullptr;
+    rhs.node_count = 0;
   }
+  return *this;
+}
 
-  // Returns a reference to the element at the index in the
-  // sequence. Throws out_of_range if index is invalid.
-  template <typename T>
-  T& ArraySeq<T>::operator[](int index)
-  {
-    if(index >= count or index < 0)
-      throw(std::out_of_range("Out of range in the [] nonconst"));
-    
-    return array[index];
-  }
+// Destructor
+template<typename T, template<typename> class NodeAlloc>
+LinkedSeq<T, NodeAlloc>::~LinkedSeq()
+{
+  make_empty();
+}
 
-  // Returns a constant address to the element at the index in the
-  // sequence. Throws out_of_range if index is invalid.
-  template <typename T>
-  const T &ArraySeq<T>::operator[](int index) const
-  {
-    if(index >= count or index < 0)
-      throw(std::out_of_range("Out of range in the [] nonconst"));
-    
-    return array[index];
-  }
+// Returns the number of elements in the sequence
+template<typename T, template<typename> class NodeAlloc>
+int LinkedSeq<T, NodeAlloc>::size() const
+{
+  return node_count;
+}
 
-  // index. Throws out_of_range if the index is invalid.
-  template <typename T>
-  void ArraySeq<T>::insert(const T& elem, int index)
-  {
-    if(index > count or index < 0)
-      throw std::out_of_range("Out of range in the [] nonconst");
-    
-    if(count + 1 > capacity)
-      resize();
-    
-    T temp1 = array[index];
-    for (int i = index; i < count; ++i)
-      {
-        T temp2 = array[i+1];
-        array[i+1] = temp1;
-        temp1 = temp2;
-      }
-      array[index] = elem;
-      count++;
-  }
+// Tests if the sequence is empty
+template<typename T, template<typename> class NodeAlloc>
+bool LinkedSeq<T, NodeAlloc>::empty() const
+{
+  return node_count == 0;
+}
 
-  // Shrinks the sequence by removing the element at the index in the
-  // sequence. Throws out_of_range if index is invalid.
-  template <typename T>
-  void ArraySeq<T>::erase(int index)
-  {
-    if(index >= count or index < 0)
-      throw std::out_of_range("Out of range in the [] nonconst");
-    
-    for(int i = index; i < count - 1; ++i)
-      array[i] = array[i + 1];
-    
-    --count;
-  }
+// Returns a reference to the element at the index in the sequence.
+// Throws out_of_range if index is invalid.
+template<typename T, template<typename> class NodeAlloc>
+T& LinkedSeq<T, NodeAlloc>::operator[](int index)
+{
+  if(index >= node_count or index < 0)
+    throw std::out_of_range("Out of range in the [] nonconst");
+  return node_at(index)->value;
+}
 
-  // Returns true if the element is in the sequence, and false
-  // otherwise.
-  template <typename T>
-  bool ArraySeq<T>::contains(const T& elem) const
-  {
-    for(int i = 0; i < count; ++i)
-    {
-      if(array[i] == elem)
-      {
-        return true;
-      }
-    }
-    return false;
-  }
+// Returns a constant address to the element at the index in the
+// sequence. Throws out_of_range if index is invalid.
+template<typename T, template<typename> class NodeAlloc>
+const T& LinkedSeq<T, NodeAlloc>::operator[](int index) const
+{
+  if(index >= node_count or index < 0)
+    throw std::out_of_range("Out of range in the [] const");
+  return node_at(index)->value;
+}
+
+// Extends the sequence by inserting the element at the given index.
+// Throws out_of_range if the index is invalid.
+template<typename T, template<typename> class NodeAlloc>
+void LinkedSeq<T, NodeAlloc>::insert(const T& elem, int index)
+{
+  emplace(index, elem);
+}
+
+// Extends the sequence by moving the element in at the given index.
+// Throws out_of_range if the index is invalid.
+template<typename T, template<typename> class NodeAlloc>
+void LinkedSeq<T, NodeAlloc>::insert(T&& elem, int index)
+{
+  emplace(index, std::move(elem));
+}
+
+// Constructs an element in a new node linked in at the given index.
+// Throws out_of_range if the index is invalid.
+template<typename T, template<typename> class NodeAlloc>
+template<typename... Args>
+T& LinkedSeq<T, NodeAlloc>::emplace(int index, Args&&... args)
+{
+  if(index > node_count or index < 0)
+    throw std::out_of_range("Out of range in insert");
 
-  // Sorts the elements in the sequence using less than equal (<=)
-  // operator. (Not implemented in HW-3)
+  // the new node goes before next (or at the tail if next is null)
+  Node* next = index == node_count ? nullptr : node_at(index);
+  Node* prev = next == nullptr ? tail : next->prev;
 
-  // helper to double the capacity of the array
-  template <typename T>
-  void ArraySeq<T>::resize()
+  Node* node = nodes.allocate();
+  try
   {
-    if(capacity == 0)
-      capacity = 1;
-    
-    else
-      capacity *= 2;
-    
-    T *new_array = new T[capacity];
-    for(int i = 0; i < capacity / 2; ++i)
-      new_array[i] = array[i];
-    
-    delete [] array;
-    array = new_array;
+    new (node) Node{T(std::forward<Args>(args)...), prev, next};
   }
-  
-  // helper to delete the array list (called by destructor and copy
-  // constructor)
-  template <typename T>
-  void ArraySeq<T>::make_empty()
+  catch(...)
   {
-    count = 0;
-    capacity = 0;
+    nodes.deallocate(node);
+    throw;
   }
+  if(prev == nullptr)
+    head = node;
+  else
+    prev->next = node;
+  if(next == nullptr)
+    tail = node;
+  else
+    next->prev = node;
+  ++node_count;
+  return node->value;
+}
 
-  template<typename T>
-  void ArraySeq<T>::sort()
-  {
-  // TODO: saved for future assignment
-  }
-  template <typename T>
-  std::ostream &operator<<(std::ostream &stream, const ArraySeq<T> &array)
+// Shrinks the sequence by removing the element at the index in the
+// sequence. Throws out_of_range if index is invalid.
+template<typename T, template<typename> class NodeAlloc>
+void LinkedSeq<T, NodeAlloc>::erase(int index)
+{
+  if(index >= node_count or index < 0)
+    throw std::out_of_range("Out of range in erase");
+
+  unlink(node_at(index));
+}
+
+// Removes the element at the iterator in O(1) and returns an iterator
+// to the element after it.
+template<typename T, template<typename> class NodeAlloc>
+typename LinkedSeq<T, NodeAlloc>::iterator LinkedSeq<T, NodeAlloc>::erase(iterator pos)
+{
+  Node* next = pos.node->next;
+  unlink(pos.node);
+  return iterator(next);
+}
+
+// Returns true if the element is in the sequence, and false
+// otherwise.
+template<typename T, template<typename> class NodeAlloc>
+bool LinkedSeq<T, NodeAlloc>::contains(const T& elem) const
+{
+  for(Node* node = head; node != nullptr; node = node->next)
+    if(node->value == elem)
+      return true;
+  return false;
+}
+
+// Preallocates nodes for growing the sequence to n elements
+template<typename T, template<typename> class NodeAlloc>
+void LinkedSeq<T, NodeAlloc>::reserve(int n)
+{
+  if(n > node_count)
+    nodes.reserve(n - node_count);
+}
+
+// Bottom-up merge sort on the links: each pass merges adjacent runs
+// of width elements into runs of twice the width, until a pass does
+// a single merge. Equal elements keep their order.
+template<typename T, template<typename> class NodeAlloc>
+void LinkedSeq<T, NodeAlloc>::sort()
+{
+  if(node_count < 2)
+    return;
+
+  Node* list = head;
+  Node* last = nullptr;
+  for(int width = 1; ; width *= 2)
   {
-    for (int i = 0; i < array.size(); i++)
+    Node* left = list;
+    list = nullptr;
+    last = nullptr;
+    int merges = 0;
+    while(left != nullptr)
     {
-        if (i != array.size() - 1)
-            stream << array[i] << ", ";
-        else 
+      ++merges;
+      Node* right = left;
+      int left_size = 0;
+      while(left_size < width and right != nullptr)
+      {
+        ++left_size;
+        right = right->next;
+      }
+      int right_size = width;
+      while(left_size > 0 or (right_size > 0 and right != nullptr))
+      {
+        Node* next;
+        if(left_size == 0 or
+           (right_size > 0 and right != nullptr and right->value < left->value))
         {
-            stream << array[i];
+          next = right;
+          right = right->next;
+          --right_size;
         }
+        else
+        {
+          next = left;
+          left = left->next;
+          --left_size;
+        }
+        if(last == nullptr)
+          list = next;
+        else
+          last->next = next;
+        next->prev = last;
+        last = next;
+      }
+      left = right;
     }
-    return stream;
+    last->next = nullptr;
+    if(merges <= 1)
+      break;
+  }
+  head = list;
+  tail = last;
 }
 
-// TODO: Implement the above functions below using the approaches
-//       discussed in class and specified in the homework assignment.
-template <typename T>
-void ArraySeq<T>::merge_sort()
+// Iterators over the elements
+template<typename T, template<typename> class NodeAlloc>
+typename LinkedSeq<T, NodeAlloc>::iterator LinkedSeq<T, NodeAlloc>::begin()
 {
-  merge_sort(0,count -1);
+  return iterator(head);
 }
 
-template <typename T>
-void ArraySeq<T>::quick_sort()
+template<typename T, template<typename> class NodeAlloc>
+typename LinkedSeq<T, NodeAlloc>::iterator LinkedSeq<T, NodeAlloc>::end()
 {
-  quick_sort(0,count-1);
+  return iterator(nullptr);
 }
 
-template <typename T>
-void ArraySeq<T>::merge_sort(int start, int end)
+template<typename T, template<typename> class NodeAlloc>
+typename LinkedSeq<T, NodeAlloc>::const_iterator LinkedSeq<T, NodeAlloc>::begin() const
 {
-  int mid = (start + end) / 2;
-  
-  if(start < end)
+  return const_iterator(head);
+}
+
+template<typename T, template<typename> class NodeAlloc>
+typename LinkedSeq<T, NodeAlloc>::const_iterator LinkedSeq<T, NodeAlloc>::end() const
+{
+  return const_iterator(nullptr);
+}
+
+// Returns the node at the index, walking from the closer end
+template<typename T, template<typename> class NodeAlloc>
+typename LinkedSeq<T, NodeAlloc>::Node* LinkedSeq<T, NodeAlloc>::node_at(int index) const
+{
+  Node* node;
+  if(index < node_count / 2)
   {
-    merge_sort(start,mid);
-    merge_sort(mid+1,end);
+    node = head;
+    for(int i = 0; i < index; ++i)
+      node = node->next;
   }
-
   else
   {
-    return;
+    node = tail;
+    for(int i = node_count - 1; i > index; --i)
+      node = node->prev;
   }
+  return node;
+}
 
-  T temp[(end-start) + 1];
-  T first1 = start;
-  T first2 = mid+1;
-  int i = 0;
-  while(first1 <= mid && first2 <= end)
-  {
-    if(array[first1] < array[first2])
-      temp[i++] = array[first1++];
+// Unlinks the node, destroys its element, and releases it
+template<typename T, template<typename> class NodeAlloc>
+void LinkedSeq<T, NodeAlloc>::unlink(Node* node)
+{
+  if(node->prev == nullptr)
+    head = node->next;
+  else
+    node->prev->next = node->next;
+  if(node->next == nullptr)
+    tail = node->prev;
+  else
+    node->next->prev = node->prev;
+  std::destroy_at(node);
+  nodes.deallocate(node);
+  --node_count;
+}
 
-    else
-      temp[i++] = array[first2++];
+// Destroys the elements and releases the nodes
+template<typename T, template<typename> class NodeAlloc>
+void LinkedSeq<T, NodeAlloc>::make_empty()
+{
+  Node* node = head;
+  while(node != nullptr)
+  {
+    Node* next = node->next;
+    std::destroy_at(node);
+    nodes.deallocate(node);
+    node = next;
   }
-  while(first1 <= mid)
-    temp[i++] = array[first1++];
-  
-  while(first2 <= end)
-    temp[i++] = array[first2++];
-  
-  for(i = 0; i <= ( end - start); ++i)
-    array[start + i] = temp[i];
+  head = tail = nullptr;
+  node_count = 0;
 }
 
-#endif
\ No newline at end of file
+static_assert(is_sequence<LinkedSeq<int>, int>::value and
+              has_static_dispatch<LinkedSeq<int>>::value,
+              "LinkedSeq must satisfy the Sequence interface statically");
+
+
+#endif
@@ -18,9 +18,46 @@
 #ifndef MAP_H
 #define MAP_H
 
+#include <cstddef>
+#include <iterator>
+#include <utility>
 #include "arrayseq.h"
 
 
+// Forward iterator over the keys of a range of key-value pairs,
+// wrapping an iterator over the pairs. Used to bulk copy keys into an
+// ArraySeq (via its range constructor, append, or insert_range)
+// without going through one insert per key.
+template<typename PairIt>
+class KeyIterator
+{
+public:
+
+  using value_type = typename std::decay<
+    decltype(std::declval<PairIt>()->first)>::type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const value_type*;
+  using reference = const value_type&;
+  using iterator_category = std::forward_iterator_tag;
+
+  explicit KeyIterator(PairIt it) : it(it) {}
+
+  reference operator*() const { return it->first; }
+  pointer operator->() const { return &it->first; }
+
+  KeyIterator& operator++() { ++it; return *this; }
+  KeyIterator operator++(int) { KeyIterator tmp = *this; ++it; return tmp; }
+
+  bool operator==(const KeyIterator& rhs) const { return it == rhs.it; }
+  bool operator!=(const KeyIterator& rhs) const { return it != rhs.it; }
+
+private:
+
+  // current position in the pairs
+  PairIt it;
+};
+
+
 template<typename K, typename V>
 class Map
 {
@@ -48,6 +85,13 @@ public:
   // collection. Insert does not check if the key is present.
   virtual void insert(const K& key, const V& value) = 0;
 
+  // Same as above, but the key and value may be moved from instead
+  // of copied. Maps that do not override it copy them.
+  virtual void insert(K&& key, V&& value)
+  {
+    insert(static_cast<const K&>(key), static_cast<const V&>(value));
+  }
+
   // Shrinks the collection by removing the key-value pair with the
   // given key. Does not modify the collection if the collection does
   // not contain the key. Throws out_of_range if the given key is not
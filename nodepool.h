@@ -0,0 +1,220 @@
+//---------------------------------------------------------------------------
+// NAME: Mason Manca
+// FILE: nodepool.h
+// DATE: Fall 2021
+// DESC: Node allocators for node-based containers. NodePool hands out
+//       nodes from slabs (arrays of nodes allocated together), keeps
+//       released nodes on a free list for reuse, and frees all its
+//       slabs at once when it is destroyed, so allocating and
+//       releasing a node is O(1) and neighboring nodes tend to sit
+//       next to each other in memory. HeapNodes allocates each node
+//       separately with new, for comparison.
+//---------------------------------------------------------------------------
+
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+#include <algorithm>
+#include <new>
+#include <utility>
+#include <vector>
+
+
+template<typename Node>
+class NodePool
+{
+public:
+
+  // Creates an empty pool (no slabs are allocated until needed)
+  NodePool() = default;
+
+  // Pools own their slabs, so they can be moved but not copied
+  NodePool(const NodePool& rhs) = delete;
+  NodePool& operator=(const NodePool& rhs) = delete;
+  NodePool(NodePool&& rhs);
+  NodePool& operator=(NodePool&& rhs);
+
+  // Frees every slab. Nodes still in use must already have been
+  // destroyed (their storage is released without running
+  // destructors).
+  ~NodePool();
+
+  // Returns uninitialized storage for one node
+  Node* allocate();
+
+  // Returns a node's storage (already destroyed) to the pool for
+  // reuse
+  void deallocate(Node* node);
+
+  // Allocates slabs (if needed) so that n more nodes can be handed
+  // out without allocating
+  void reserve(int n);
+
+private:
+
+  // storage for one node, or a link in the free list once released
+  union Slot
+  {
+    Slot* next;
+    alignas(Node) unsigned char storage[sizeof(Node)];
+  };
+
+  // smallest and largest number of nodes per slab (slabs double in
+  // size as the pool grows)
+  static constexpr int min_slab = 16;
+  static constexpr int max_slab = 4096;
+
+  // allocated slabs and their sizes (in slots)
+  std::vector<std::pair<Slot*, int>> slabs;
+
+  // released slots available for reuse
+  Slot* free_list = nullptr;
+
+  // never used slots at the end of the newest slab
+  Slot* bump = nullptr;
+  Slot* bump_end = nullptr;
+
+  // helper to allocate a new slab of at least n slots
+  void add_slab(int n);
+
+  // helper to free every slab
+  void release();
+};
+
+
+template<typename Node>
+class HeapNodes
+{
+public:
+
+  // Returns uninitialized storage for one node
+  Node* allocate();
+
+  // Frees a node's storage (already destroyed)
+  void deallocate(Node* node);
+
+  // Nothing to preallocate
+  void reserve(int /*n*/) {}
+};
+
+
+// Moves the slabs (and free nodes) of rhs into a new pool
+template<typename Node>
+NodePool<Node>::NodePool(NodePool&& rhs)
+  : slabs(std::move(rhs.slabs)), free_list(rhs.free_list),
+    bump(rhs.bump), bump_end(rhs.bump_end)
+{
+  rhs.slabs.clear();
+  rhs.free_list = rhs.bump = rhs.bump_end = nullptr;
+}
+
+// Frees this pool's slabs and takes over those of rhs
+template<typename Node>
+NodePool<Node>& NodePool<Node>::operator=(NodePool&& rhs)
+{
+  if(this != &rhs)
+  {
+    release();
+    slabs = std::move(rhs.slabs);
+    free_list = rhs.free_list;
+    bump = rhs.bump;
+    bump_end = rhs.bump_end;
+    rhs.slabs.clear();
+    rhs.free_list = rhs.bump = rhs.bump_end = nullptr;
+  }
+  return *this;
+}
+
+// Frees every slab
+template<typename Node>
+NodePool<Node>::~NodePool()
+{
+  release();
+}
+
+// Returns storage for one node, reusing a released node if there is
+// one, then the unused end of the newest slab, then a new slab
+template<typename Node>
+Node* NodePool<Node>::allocate()
+{
+  Slot* slot;
+  if(free_list != nullptr)
+  {
+    slot = free_list;
+    free_list = free_list->next;
+  }
+  else
+  {
+    if(bump == bump_end)
+      add_slab(slabs.empty() ? min_slab : std::min(slabs.back().second * 2, max_slab));
+    slot = bump++;
+  }
+  return reinterpret_cast<Node*>(slot->storage);
+}
+
+// Pushes the node's storage onto the free list
+template<typename Node>
+void NodePool<Node>::deallocate(Node* node)
+{
+  Slot* slot = reinterpret_cast<Slot*>(node);
+  slot->next = free_list;
+  free_list = slot;
+}
+
+// Allocates a slab big enough for n more nodes if the free list and
+// the current slab cannot supply them
+template<typename Node>
+void NodePool<Node>::reserve(int n)
+{
+  int available = bump_end - bump;
+  for(Slot* s = free_list; s != nullptr and available < n; s = s->next)
+    ++available;
+  if(available < n)
+  {
+    // the rest of the current slab goes onto the free list so it is
+    // not lost when the new slab becomes the bump slab
+    while(bump != bump_end)
+    {
+      bump->next = free_list;
+      free_list = bump++;
+    }
+    add_slab(n - available);
+  }
+}
+
+// Allocates a new slab of at least n slots and bump allocates from it
+template<typename Node>
+void NodePool<Node>::add_slab(int n)
+{
+  Slot* slab = static_cast<Slot*>(::operator new(n * sizeof(Slot)));
+  slabs.push_back({slab, n});
+  bump = slab;
+  bump_end = slab + n;
+}
+
+// Frees every slab
+template<typename Node>
+void NodePool<Node>::release()
+{
+  for(std::pair<Slot*, int>& slab : slabs)
+    ::operator delete(slab.first);
+  slabs.clear();
+  free_list = bump = bump_end = nullptr;
+}
+
+// Allocates one node with new
+template<typename Node>
+Node* HeapNodes<Node>::allocate()
+{
+  return static_cast<Node*>(::operator new(sizeof(Node)));
+}
+
+// Frees one node with delete
+template<typename Node>
+void HeapNodes<Node>::deallocate(Node* node)
+{
+  ::operator delete(node);
+}
+
+
+#endif
@@ -0,0 +1,195 @@
+//---------------------------------------------------------------------------
+// NAME: Mason Manca
+// FILE: pairlayout.h
+// DATE: Fall 2021
+// DESC: Storage layouts for the sorted key-value pairs of a
+//       BinSearchMap. PairLayout keeps one sequence of pairs (array of
+//       structs). SplitLayout keeps the keys and the values in two
+//       parallel sequences (struct of arrays), so a binary search
+//       only touches the dense key array and a value is read only
+//       once its key is found, which keeps more keys per cache line
+//       when values are large.
+//---------------------------------------------------------------------------
+
+#ifndef PAIRLAYOUT_H
+#define PAIRLAYOUT_H
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "arrayseq.h"
+#include "keyview.h"
+#include "map.h"
+
+
+template<typename K, typename V, template<typename> class Seq>
+class PairLayout
+{
+public:
+
+  // true if the keys are in one block of memory (a fixed stride
+  // apart), so they can be viewed in place
+  static constexpr bool contiguous =
+    std::is_same<Seq<std::pair<K,V>>, ArraySeq<std::pair<K,V>>>::value;
+
+  // Returns the number of pairs
+  int size() const { return seq.size(); }
+
+  // Tests if there are no pairs
+  bool empty() const { return seq.empty(); }
+
+  // Returns the key or value of the pair at the index (which must be
+  // valid)
+  const K& key(int index) const { return seq.at_unchecked(index).first; }
+  V& value(int index) { return seq.at_unchecked(index).second; }
+  const V& value(int index) const { return seq.at_unchecked(index).second; }
+
+  // Inserts a pair at the index with the key forwarded and the value
+  // constructed from the arguments
+  template<typename KArg, typename... Args>
+  void emplace(int index, KArg&& key, Args&&... args);
+
+  // Removes the pair at the index
+  void erase(int index) { seq.erase(index); }
+
+  // Returns a copy of the keys of the pairs in [start, end)
+  ArraySeq<K> copy_keys(int start, int end) const;
+
+  // Returns a view of the keys of the pairs in [start, end), which
+  // must not be empty (contiguous only)
+  KeyView<K> key_view(int start, int end) const;
+
+private:
+
+  // the pairs in key order
+  Seq<std::pair<K,V>> seq;
+};
+
+
+template<typename K, typename V, template<typename> class Seq>
+class SplitLayout
+{
+public:
+
+  // true if the keys are in one block of memory, so they can be
+  // viewed in place
+  static constexpr bool contiguous =
+    std::is_same<Seq<K>, ArraySeq<K>>::value;
+
+  // Returns the number of pairs
+  int size() const { return keys.size(); }
+
+  // Tests if there are no pairs
+  bool empty() const { return keys.empty(); }
+
+  // Returns the key or value of the pair at the index (which must be
+  // valid)
+  const K& key(int index) const { return keys.at_unchecked(index); }
+  V& value(int index) { return values.at_unchecked(index); }
+  const V& value(int index) const { return values.at_unchecked(index); }
+
+  // Inserts a pair at the index with the key forwarded and the value
+  // constructed from the arguments
+  template<typename KArg, typename... Args>
+  void emplace(int index, KArg&& key, Args&&... args);
+
+  // Removes the pair at the index
+  void erase(int index);
+
+  // Returns a copy of the keys of the pairs in [start, end)
+  ArraySeq<K> copy_keys(int start, int end) const;
+
+  // Returns a view of the keys of the pairs in [start, end), which
+  // must not be empty (contiguous only)
+  KeyView<K> key_view(int start, int end) const;
+
+private:
+
+  // the keys in order, and their values at the same indexes
+  Seq<K> keys;
+  Seq<V> values;
+};
+
+
+// Constructs the pair in place from the key and the value arguments
+template<typename K, typename V, template<typename> class Seq>
+template<typename KArg, typename... Args>
+void PairLayout<K,V,Seq>::emplace(int index, KArg&& key, Args&&... args)
+{
+  seq.emplace(index, std::piecewise_construct,
+              std::forward_as_tuple(std::forward<KArg>(key)),
+              std::forward_as_tuple(std::forward<Args>(args)...));
+}
+
+// Copies the keys out of the pairs
+template<typename K, typename V, template<typename> class Seq>
+ArraySeq<K> PairLayout<K,V,Seq>::copy_keys(int start, int end) const
+{
+  if(start == end)
+    return ArraySeq<K>();
+  if constexpr (contiguous)
+    return key_view(start, end).to_seq();
+  else
+    return ArraySeq<K>(KeyIterator(seq.begin() + start),
+                       KeyIterator(seq.begin() + end));
+}
+
+// Views the keys in place, one pair size apart
+template<typename K, typename V, template<typename> class Seq>
+KeyView<K> PairLayout<K,V,Seq>::key_view(int start, int end) const
+{
+  static_assert(contiguous, "key views need contiguous (ArraySeq) storage");
+  return KeyView<K>(&seq.data()[start].first, end - start,
+                    sizeof(std::pair<K,V>));
+}
+
+// Inserts the value first (it is built before anything moves, so the
+// arguments may refer into the map), then the key. If inserting the
+// key throws, the value is removed again so the two sequences stay
+// the same length.
+template<typename K, typename V, template<typename> class Seq>
+template<typename KArg, typename... Args>
+void SplitLayout<K,V,Seq>::emplace(int index, KArg&& key, Args&&... args)
+{
+  values.emplace(index, std::forward<Args>(args)...);
+  try
+  {
+    keys.emplace(index, std::forward<KArg>(key));
+  }
+  catch(...)
+  {
+    values.erase(index);
+    throw;
+  }
+}
+
+// Removes the key and its value
+template<typename K, typename V, template<typename> class Seq>
+void SplitLayout<K,V,Seq>::erase(int index)
+{
+  keys.erase(index);
+  values.erase(index);
+}
+
+// Copies a range of the key sequence
+template<typename K, typename V, template<typename> class Seq>
+ArraySeq<K> SplitLayout<K,V,Seq>::copy_keys(int start, int end) const
+{
+  if(start == end)
+    return ArraySeq<K>();
+  if constexpr (contiguous)
+    return key_view(start, end).to_seq();
+  else
+    return ArraySeq<K>(keys.begin() + start, keys.begin() + end);
+}
+
+// Views the keys in place (they are adjacent)
+template<typename K, typename V, template<typename> class Seq>
+KeyView<K> SplitLayout<K,V,Seq>::key_view(int start, int end) const
+{
+  static_assert(contiguous, "key views need contiguous (ArraySeq) storage");
+  return KeyView<K>(keys.data() + start, end - start);
+}
+
+
+#endif
@@ -23,6 +23,7 @@ outfile4 = "find_range_graph.png"
 outfile5 = "sorted_keys_graph.png"
 outfile6 = "array-binsearch-no-sort-graph.png"
 outfile7 = "array-binsearch-sort-graph.png"
+outfile8 = "lookup_graph.png"
 
 # color scheme
 RED = "#e6194B"
@@ -72,47 +73,52 @@ set yrange [0:*] noreverse writeback
 set output outfile1
 
 # Plot the data
-set title "BinSearchMap vs ArrayMap vs LinkedMap Insert Performance";
+set title "BinSearchMap vs ArrayMap vs LinkedMap vs HashMap Insert Performance";
 plot  infile u 1:2 t "BinSearchMap Insert" w linespoints lw 3 lc rgb RED pointtype 6, \
       infile u 1:3 t "ArrayMap Insert" w linespoints lw 3 lc rgb GREEN pointtype 6, \
-      infile u 1:4 t "LinkedMap Insert" w linespoints lw 3 lc rgb YELLOW pointtype 6;
+      infile u 1:4 t "LinkedMap Insert" w linespoints lw 3 lc rgb YELLOW pointtype 6, \
+      infile u 1:20 t "HashMap Insert" w linespoints lw 3 lc rgb BLUE pointtype 6;
 
 
 # Save the graph
 set output outfile2
 
 # Plot the data
-set title "BinSearchMap vs ArrayMap vs LinkedMap Erase Performance";
+set title "BinSearchMap vs ArrayMap vs LinkedMap vs HashMap Erase Performance";
 plot  infile u 1:5 t "BinSearchMap Erase" w linespoints lw 3 lc rgb RED pointtype 6, \
       infile u 1:6 t "ArrayMap Erase" w linespoints lw 3 lc rgb GREEN pointtype 6, \
-      infile u 1:7 t "LinkedMap Erase" w linespoints lw 3 lc rgb YELLOW pointtype 6;
+      infile u 1:7 t "LinkedMap Erase" w linespoints lw 3 lc rgb YELLOW pointtype 6, \
+      infile u 1:21 t "HashMap Erase" w linespoints lw 3 lc rgb BLUE pointtype 6;
 
 # Save the graph
 set output outfile3
 
 # Plot the data
-set title "BinSearchMap vs ArrayMap vs LinkedMap Contains Performance";
+set title "BinSearchMap vs ArrayMap vs LinkedMap vs HashMap Contains Performance";
 plot  infile u 1:8 t "BinSearchMap Contains" w linespoints lw 3 lc rgb RED pointtype 6, \
       infile u 1:9 t "ArrayMap Contains" w linespoints lw 3 lc rgb GREEN pointtype 6, \
-      infile u 1:10 t "LinkedMap Contains" w linespoints lw 3 lc rgb YELLOW pointtype 6;
+      infile u 1:10 t "LinkedMap Contains" w linespoints lw 3 lc rgb YELLOW pointtype 6, \
+      infile u 1:22 t "HashMap Contains" w linespoints lw 3 lc rgb BLUE pointtype 6;
 
 # Save the graph
 set output outfile4
 
 # Plot the data
-set title "BinSearchMap vs ArrayMap vs LinkedMap Find Range Performance";
+set title "BinSearchMap vs ArrayMap vs LinkedMap vs HashMap Find Range Performance";
 plot  infile u 1:11 t "BinSearchMap Find Range" w linespoints lw 3 lc rgb RED pointtype 6, \
       infile u 1:12 t "ArrayMap Find Range" w linespoints lw 3 lc rgb GREEN pointtype 6, \
-      infile u 1:13 t "LinkedMap Find Range" w linespoints lw 3 lc rgb YELLOW pointtype 6;
+      infile u 1:13 t "LinkedMap Find Range" w linespoints lw 3 lc rgb YELLOW pointtype 6, \
+      infile u 1:23 t "HashMap Find Range" w linespoints lw 3 lc rgb BLUE pointtype 6;
 
 # Save the graph
 set output outfile5
 
 # Plot the data
-set title "BinSearchMap vs ArrayMap vs LinkedMap Sorted Keys Performance";
+set title "BinSearchMap vs ArrayMap vs LinkedMap vs HashMap Sorted Keys Performance";
 plot  infile u 1:14 t "BinSearchMap Sorted Keys" w linespoints lw 3 lc rgb RED pointtype 6, \
       infile u 1:15 t "ArrayMap Sorted Keys" w linespoints lw 3 lc rgb GREEN pointtype 6, \
-      infile u 1:16 t "LinkedMap Sorted Keys" w linespoints lw 3 lc rgb YELLOW pointtype 6;
+      infile u 1:16 t "LinkedMap Sorted Keys" w linespoints lw 3 lc rgb YELLOW pointtype 6, \
+      infile u 1:24 t "HashMap Sorted Keys" w linespoints lw 3 lc rgb BLUE pointtype 6;
 
 # Save the graph
 set output outfile6
@@ -136,9 +142,12 @@ set title "BinSearchMap vs ArrayMap Sorted Keys Performance";
 plot  infile u 1:14 t "BinSearchMap Sorted Keys" w linespoints lw 3 lc rgb RED pointtype 6, \
       infile u 1:15 t "ArrayMap Sorted Keys" w linespoints lw 3 lc rgb GREEN pointtype 6;
 
+# Save the graph
+set output outfile8
 
-
-
-
-
-
+# Plot the data
+set title "BinSearchMap vs ArrayMap vs LinkedMap vs HashMap Lookup Performance";
+plot  infile u 1:17 t "BinSearchMap Lookup" w linespoints lw 3 lc rgb RED pointtype 6, \
+      infile u 1:18 t "ArrayMap Lookup" w linespoints lw 3 lc rgb GREEN pointtype 6, \
+      infile u 1:19 t "LinkedMap Lookup" w linespoints lw 3 lc rgb YELLOW pointtype 6, \
+      infile u 1:25 t "HashMap Lookup" w linespoints lw 3 lc rgb BLUE pointtype 6;
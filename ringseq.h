@@ -0,0 +1,508 @@
+//---------------------------------------------------------------------------
+// NAME: Mason Manca
+// FILE: ringseq.h
+// DATE: Fall 2021
+// DESC: Ring buffer (deque) implementation of Sequence. The elements
+//       are stored in a circular array whose size is a power of two,
+//       starting at a head index that can move in either direction,
+//       so inserting or erasing at either end is O(1) amortized. An
+//       insert or erase in the middle shifts whichever side of the
+//       index is shorter.
+//---------------------------------------------------------------------------
+
+#ifndef RINGSEQ_H
+#define RINGSEQ_H
+
+#include <stdexcept>
+#include <ostream>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <utility>
+#include "sequence.h"
+#include "arrayseq.h"
+#include "indexiterator.h"
+#include "interface.h"
+
+
+template<typename T>
+class RingSeq final : public Sequence<T>
+{
+public:
+
+  // Random access iterators over the elements (by index)
+  using iterator = IndexIterator<RingSeq*, T&>;
+  using const_iterator = IndexIterator<const RingSeq*, const T&>;
+
+  // Default constructor
+  RingSeq();
+
+  // Copy constructor
+  RingSeq(const RingSeq& rhs);
+
+  // Move constructor
+  RingSeq(RingSeq&& rhs);
+
+  // Copy assignment operator
+  RingSeq& operator=(const RingSeq& rhs);
+
+  // Move assignment operator
+  RingSeq& operator=(RingSeq&& rhs);
+
+  // Destructor
+  ~RingSeq();
+
+  // Returns the number of elements in the sequence
+  int size() const;
+
+  // Tests if the sequence is empty
+  bool empty() const;
+
+  // Returns a reference to the element at the index in the
+  // sequence. Throws out_of_range if index is invalid.
+  T& operator[](int index);
+
+  // Returns a constant address to the element at the index in the
+  // sequence. Throws out_of_range if index is invalid.
+  const T& operator[](int index) const;
+
+  // Returns the element at the index without checking the index.
+  // The index must be valid.
+  T& at_unchecked(int index);
+  const T& at_unchecked(int index) const;
+
+  // Extends the sequence by inserting the element at the given
+  // index. Throws out_of_range if the index is invalid.
+  void insert(const T& elem, int index);
+
+  // Same as above, moving the element into the sequence instead of
+  // copying it.
+  void insert(T&& elem, int index);
+
+  // Extends the sequence by constructing an element at the given
+  // index from the arguments (forwarded to T's constructor), and
+  // returns a reference to it. Throws out_of_range if the index is
+  // invalid.
+  template<typename... Args>
+  T& emplace(int index, Args&&... args);
+
+  // Shrinks the sequence by removing the element at the index in the
+  // sequence. Throws out_of_range if index is invalid.
+  void erase(int index);
+
+  // Returns true if the element is in the sequence, and false
+  // otherwise.
+  bool contains(const T& elem) const;
+
+  // Grows the array (if needed) so that it can hold at least n
+  // elements without reallocating.
+  void reserve(int n);
+
+  // Sorts the elements in the sequence using less than (<), by
+  // sorting them in an ArraySeq and moving them back.
+  void sort();
+
+  // Iterators over the elements
+  iterator begin();
+  iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
+
+private:
+
+  // raw circular storage, element i is at (head + i) & (cap - 1)
+  T* array = nullptr;
+
+  // size of the array (0 or a power of two)
+  int cap = 0;
+
+  // slot of the first element
+  int head = 0;
+
+  // number of elements
+  int count = 0;
+
+  // helper to return the element (or raw slot) at the index
+  T& slot(int index) const;
+
+  // helper to move n elements starting at index src so they start at
+  // index dst (one apart) as raw bytes, for bitwise movable types
+  void move_bytes(int dst, int src, int n);
+
+  // helper to move the elements into a new array of the given
+  // capacity (a power of two, at least count), starting at slot 0
+  void reallocate(int new_cap);
+
+  // helper to destroy the elements and free the array
+  void make_empty();
+
+};
+
+
+template<typename T>
+std::ostream& operator<<(std::ostream& stream, const RingSeq<T>& seq)
+{
+  for(int i = 0; i < seq.size(); ++i)
+  {
+    if(i > 0)
+      stream << ", ";
+    stream << seq.at_unchecked(i);
+  }
+  return stream;
+}
+
+
+// Default constructor
+template<typename T>
+RingSeq<T>::RingSeq()
+{
+}
+
+// Copy constructor
+template<typename T>
+RingSeq<T>::RingSeq(const RingSeq& rhs)
+{
+  *this = rhs;
+}
+
+// Move constructor
+template<typename T>
+RingSeq<T>::RingSeq(RingSeq&& rhs)
+{
+  *this = std::move(rhs);
+}
+
+// Copy assignment operator
+template<typename T>
+RingSeq<T>& RingSeq<T>::operator=(const RingSeq& rhs)
+{
+  if(this != &rhs)
+  {
+    make_empty();
+    reserve(rhs.count);
+    for(int i = 0; i < rhs.count; ++i)
+      emplace(count, rhs.at_unchecked(i));
+  }
+  return *this;
+}
+
+// Move assignment operator
+template<typename T>
+RingSeq<T>& RingSeq<T>::operator=(RingSeq&& rhs)
+{
+  if(this != &rhs)
+  {
+    make_empty();
+    array = rhs.array;
+    cap = rhs.cap;
+    head = rhs.head;
+    count = rhs.count;
+    rhs.array = nullptr;
+    rhs.cap = rhs.head = rhs.count = 0;
+  }
+  return *this;
+}
+
+// Destructor
+template<typename T>
+RingSeq<T>::~RingSeq()
+{
+  make_empty();
+}
+
+// Returns the number of elements in the sequence
+template<typename T>
+int RingSeq<T>::size() const
+{
+  return count;
+}
+
+// Tests if the sequence is empty
+template<typename T>
+bool RingSeq<T>::empty() const
+{
+  return count == 0;
+}
+
+// Returns a reference to the element at the index in the sequence.
+// Throws out_of_range if index is invalid.
+template<typename T>
+T& RingSeq<T>::operator[](int index)
+{
+  if(index >= count or index < 0)
+    throw std::out_of_range("Out of range in the [] nonconst");
+  return slot(index);
+}
+
+// Returns a constant address to the element at the index in the
+// sequence. Throws out_of_range if index is invalid.
+template<typename T>
+const T& RingSeq<T>::operator[](int index) const
+{
+  if(index >= count or index < 0)
+    throw std::out_of_range("Out of range in the [] const");
+  return slot(index);
+}
+
+// Returns the element at the index without checking the index
+template<typename T>
+T& RingSeq<T>::at_unchecked(int index)
+{
+  return slot(index);
+}
+
+template<typename T>
+const T& RingSeq<T>::at_unchecked(int index) const
+{
+  return slot(index);
+}
+
+// Extends the sequence by inserting the element at the given index.
+// Throws out_of_range if the index is invalid.
+template<typename T>
+void RingSeq<T>::insert(const T& elem, int index)
+{
+  emplace(index, elem);
+}
+
+// Extends the sequence by moving the element in at the given index.
+// Throws out_of_range if the index is invalid.
+template<typename T>
+void RingSeq<T>::insert(T&& elem, int index)
+{
+  emplace(index, std::move(elem));
+}
+
+// Constructs an element at the given index. The elements before the
+// index move one slot toward the front (the head moves back) if there
+// are fewer of them than after the index, otherwise the elements
+// after it move one slot toward the back. Throws out_of_range if the
+// index is invalid.
+template<typename T>
+template<typename... Args>
+T& RingSeq<T>::emplace(int index, Args&&... args)
+{
+  if(index > count or index < 0)
+    throw std::out_of_range("Out of range in insert");
+
+  // the arguments may refer into the sequence, which the moves below
+  // would invalidate, so the element is built first
+  T elem(std::forward<Args>(args)...);
+  if(count == cap)
+    reallocate(cap == 0 ? 1 : cap * 2);
+
+  if constexpr (is_bitwise_movable<T>::value)
+  {
+    if(index < count - index)
+    {
+      head = (head - 1) & (cap - 1);
+      move_bytes(0, 1, index);
+    }
+    else
+      move_bytes(index + 1, index, count - index);
+    new (&slot(index)) T(std::move(elem));
+  }
+  else if(index < count - index)
+  {
+    head = (head - 1) & (cap - 1);
+    if(index == 0)
+      new (&slot(0)) T(std::move(elem));
+    else
+    {
+      new (&slot(0)) T(std::move(slot(1)));
+      for(int p = 1; p < index; ++p)
+        slot(p) = std::move(slot(p + 1));
+      slot(index) = std::move(elem);
+    }
+  }
+  else
+  {
+    if(index == count)
+      new (&slot(count)) T(std::move(elem));
+    else
+    {
+      new (&slot(count)) T(std::move(slot(count - 1)));
+      for(int p = count - 1; p > index; --p)
+        slot(p) = std::move(slot(p - 1));
+      slot(index) = std::move(elem);
+    }
+  }
+  ++count;
+  return slot(index);
+}
+
+// Shrinks the sequence by removing the element at the index, closing
+// the hole from whichever side is shorter. Throws out_of_range if
+// index is invalid.
+template<typename T>
+void RingSeq<T>::erase(int index)
+{
+  if(index >= count or index < 0)
+    throw std::out_of_range("Out of range in erase");
+
+  if constexpr (is_bitwise_movable<T>::value)
+  {
+    std::destroy_at(&slot(index));
+    if(index < count - 1 - index)
+    {
+      move_bytes(1, 0, index);
+      head = (head + 1) & (cap - 1);
+    }
+    else
+      move_bytes(index, index + 1, count - 1 - index);
+  }
+  else if(index < count - 1 - index)
+  {
+    for(int p = index; p > 0; --p)
+      slot(p) = std::move(slot(p - 1));
+    std::destroy_at(&slot(0));
+    head = (head + 1) & (cap - 1);
+  }
+  else
+  {
+    for(int p = index; p < count - 1; ++p)
+      slot(p) = std::move(slot(p + 1));
+    std::destroy_at(&slot(count - 1));
+  }
+  --count;
+}
+
+// Returns true if the element is in the sequence, and false
+// otherwise.
+template<typename T>
+bool RingSeq<T>::contains(const T& elem) const
+{
+  for(int i = 0; i < count; ++i)
+    if(slot(i) == elem)
+      return true;
+  return false;
+}
+
+// Grows the array to hold at least n elements
+template<typename T>
+void RingSeq<T>::reserve(int n)
+{
+  if(n > cap)
+  {
+    int new_cap = cap == 0 ? 1 : cap;
+    while(new_cap < n)
+      new_cap *= 2;
+    reallocate(new_cap);
+  }
+}
+
+// Sorts by moving the elements into an ArraySeq (which picks radix
+// sort or introsort), sorting, and moving them back in order
+template<typename T>
+void RingSeq<T>::sort()
+{
+  if(count < 2)
+    return;
+  ArraySeq<T> sorted;
+  sorted.reserve(count);
+  for(int i = 0; i < count; ++i)
+    sorted.insert(std::move(slot(i)), i);
+  sorted.sort();
+  for(int i = 0; i < count; ++i)
+    slot(i) = std::move(sorted.at_unchecked(i));
+}
+
+// Iterators over the elements
+template<typename T>
+typename RingSeq<T>::iterator RingSeq<T>::begin()
+{
+  return iterator(this, 0);
+}
+
+template<typename T>
+typename RingSeq<T>::iterator RingSeq<T>::end()
+{
+  return iterator(this, count);
+}
+
+template<typename T>
+typename RingSeq<T>::const_iterator RingSeq<T>::begin() const
+{
+  return const_iterator(this, 0);
+}
+
+template<typename T>
+typename RingSeq<T>::const_iterator RingSeq<T>::end() const
+{
+  return const_iterator(this, count);
+}
+
+// Returns the element (or raw slot) at the index
+template<typename T>
+T& RingSeq<T>::slot(int index) const
+{
+  return array[(head + index) & (cap - 1)];
+}
+
+// Moves the elements with memmove, one run at a time so that neither
+// the source nor the destination run wraps around the array. Shifting
+// right goes from the back, shifting left from the front, so the
+// overlapping runs are read before they are overwritten.
+template<typename T>
+void RingSeq<T>::move_bytes(int dst, int src, int n)
+{
+  int mask = cap - 1;
+  if(dst > src)
+    while(n > 0)
+    {
+      int s = (head + src + n - 1) & mask;
+      int d = (head + dst + n - 1) & mask;
+      int run = std::min(n, std::min(s, d) + 1);
+      std::memmove(static_cast<void*>(array + d - run + 1), array + s - run + 1,
+                   run * sizeof(T));
+      n -= run;
+    }
+  else
+    while(n > 0)
+    {
+      int s = (head + src) & mask;
+      int d = (head + dst) & mask;
+      int run = std::min(n, cap - std::max(s, d));
+      std::memmove(static_cast<void*>(array + d), array + s, run * sizeof(T));
+      src += run;
+      dst += run;
+      n -= run;
+    }
+}
+
+// Moves the elements in order into a new array starting at slot 0
+template<typename T>
+void RingSeq<T>::reallocate(int new_cap)
+{
+  T* new_array = std::allocator<T>().allocate(new_cap);
+  for(int i = 0; i < count; ++i)
+  {
+    new (new_array + i) T(std::move(slot(i)));
+    std::destroy_at(&slot(i));
+  }
+  if(array != nullptr)
+    std::allocator<T>().deallocate(array, cap);
+  array = new_array;
+  cap = new_cap;
+  head = 0;
+}
+
+// Destroys the elements and frees the array
+template<typename T>
+void RingSeq<T>::make_empty()
+{
+  for(int i = 0; i < count; ++i)
+    std::destroy_at(&slot(i));
+  if(array != nullptr)
+    std::allocator<T>().deallocate(array, cap);
+  array = nullptr;
+  cap = head = count = 0;
+}
+
+static_assert(is_sequence<RingSeq<int>, int>::value and
+              has_static_dispatch<RingSeq<int>>::value,
+              "RingSeq must satisfy the Sequence interface statically");
+
+
+#endif
@@ -42,6 +42,13 @@ public:
   // than 0 or greater than size()).
   virtual void insert(const T& elem, int index) = 0;
 
+  // Same as above, but the element may be moved from instead of
+  // copied. Sequences that do not override it copy the element.
+  virtual void insert(T&& elem, int index)
+  {
+    insert(static_cast<const T&>(elem), index);
+  }
+
   // Shrinks the sequence by removing the element at the index in the
   // sequence (shifing elements to the "left" in the sequence). Throws
   // out_of_range if index is invalid.
@@ -51,6 +58,11 @@ public:
   // otherwise.
   virtual bool contains(const T& elem) const = 0;
 
+  // Hint that the sequence is about to grow to at least n elements,
+  // so that bulk loads can allocate once up front. Sequences without
+  // preallocated storage can ignore it.
+  virtual void reserve(int /*n*/) {}
+
   // Sorts the elements in the sequence using less than equal (<=)
   // operator.
   virtual void sort() = 0; 
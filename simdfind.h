@@ -0,0 +1,195 @@
+//---------------------------------------------------------------------------
+// NAME: Mason Manca
+// FILE: simdfind.h
+// DATE: Fall 2021
+// DESC: Vectorized linear search over contiguous arrays. Integral
+//       elements are compared 16 bytes at a time with SSE2 (or 32
+//       bytes with AVX2 when the CPU supports it, checked once at run
+//       time), float and double with SSE2, and everything else (or
+//       any element type on non-x86 targets) with a scalar loop.
+//---------------------------------------------------------------------------
+
+#ifndef SIMDFIND_H
+#define SIMDFIND_H
+
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#define SIMDFIND_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(SIMDFIND_SSE2) && defined(__x86_64__)
+#define SIMDFIND_AVX2 1
+#include <immintrin.h>
+#endif
+
+
+//----------------------------------------------------------------------
+// Returns the index of the first element in [first, first + n) that
+// is equal (==) to value, or -1 if there is no such element.
+//----------------------------------------------------------------------
+template<typename T>
+int simd_find(const T* first, int n, const T& value);
+
+
+namespace simdfind_detail
+{
+  // scalar fallback, also used for the tail after the vector loop
+  template<typename T>
+  int scalar_find(const T* first, int start, int n, const T& value)
+  {
+    for (int i = start; i < n; ++i)
+      if (first[i] == value)
+        return i;
+    return -1;
+  }
+
+#ifdef SIMDFIND_SSE2
+
+  // 16 byte broadcast and lane compare for W byte integers (SSE2 has
+  // no 64-bit compare, so it is built from two 32-bit compares)
+  template<int W> inline __m128i set1_128(const void* value);
+  template<> inline __m128i set1_128<1>(const void* v)
+  { char x; std::memcpy(&x, v, 1); return _mm_set1_epi8(x); }
+  template<> inline __m128i set1_128<2>(const void* v)
+  { short x; std::memcpy(&x, v, 2); return _mm_set1_epi16(x); }
+  template<> inline __m128i set1_128<4>(const void* v)
+  { int x; std::memcpy(&x, v, 4); return _mm_set1_epi32(x); }
+  template<> inline __m128i set1_128<8>(const void* v)
+  { long long x; std::memcpy(&x, v, 8); return _mm_set1_epi64x(x); }
+
+  template<int W> inline __m128i cmpeq_128(__m128i a, __m128i b);
+  template<> inline __m128i cmpeq_128<1>(__m128i a, __m128i b)
+  { return _mm_cmpeq_epi8(a, b); }
+  template<> inline __m128i cmpeq_128<2>(__m128i a, __m128i b)
+  { return _mm_cmpeq_epi16(a, b); }
+  template<> inline __m128i cmpeq_128<4>(__m128i a, __m128i b)
+  { return _mm_cmpeq_epi32(a, b); }
+  template<> inline __m128i cmpeq_128<8>(__m128i a, __m128i b)
+  {
+    __m128i eq = _mm_cmpeq_epi32(a, b);
+    return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+  }
+
+  template<typename T>
+  int sse2_find_int(const T* first, int n, const T& value)
+  {
+    const int W = sizeof(T);
+    const int lanes = 16 / W;
+    __m128i needle = set1_128<W>(&value);
+    int i = 0;
+    for (; i + lanes <= n; i += lanes) {
+      __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i));
+      int mask = _mm_movemask_epi8(cmpeq_128<W>(block, needle));
+      if (mask != 0)
+        return i + __builtin_ctz(mask) / W;
+    }
+    return scalar_find(first, i, n, value);
+  }
+
+  inline int sse2_find_float(const float* first, int n, float value)
+  {
+    __m128 needle = _mm_set1_ps(value);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+      int mask = _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(first + i), needle));
+      if (mask != 0)
+        return i + __builtin_ctz(mask);
+    }
+    return scalar_find(first, i, n, value);
+  }
+
+  inline int sse2_find_double(const double* first, int n, double value)
+  {
+    __m128d needle = _mm_set1_pd(value);
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+      int mask = _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(first + i), needle));
+      if (mask != 0)
+        return i + __builtin_ctz(mask);
+    }
+    return scalar_find(first, i, n, value);
+  }
+
+#endif
+
+#ifdef SIMDFIND_AVX2
+
+  // true if the running CPU supports AVX2 (checked once)
+  inline bool has_avx2()
+  {
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+  }
+
+  template<int W>
+  __attribute__((target("avx2"))) inline __m256i cmpeq_256(__m256i a, __m256i b)
+  {
+    if constexpr (W == 1)
+      return _mm256_cmpeq_epi8(a, b);
+    else if constexpr (W == 2)
+      return _mm256_cmpeq_epi16(a, b);
+    else if constexpr (W == 4)
+      return _mm256_cmpeq_epi32(a, b);
+    else
+      return _mm256_cmpeq_epi64(a, b);
+  }
+
+  template<typename T>
+  __attribute__((target("avx2"))) int avx2_find_int(const T* first, int n, const T& value)
+  {
+    const int W = sizeof(T);
+    const int lanes = 32 / W;
+    __m256i needle;
+    if constexpr (W == 1) {
+      char x; std::memcpy(&x, &value, 1); needle = _mm256_set1_epi8(x);
+    }
+    else if constexpr (W == 2) {
+      short x; std::memcpy(&x, &value, 2); needle = _mm256_set1_epi16(x);
+    }
+    else if constexpr (W == 4) {
+      int x; std::memcpy(&x, &value, 4); needle = _mm256_set1_epi32(x);
+    }
+    else {
+      long long x; std::memcpy(&x, &value, 8); needle = _mm256_set1_epi64x(x);
+    }
+    int i = 0;
+    for (; i + lanes <= n; i += lanes) {
+      __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i));
+      unsigned mask = _mm256_movemask_epi8(cmpeq_256<W>(block, needle));
+      if (mask != 0)
+        return i + __builtin_ctz(mask) / W;
+    }
+    return scalar_find(first, i, n, value);
+  }
+
+#endif
+}
+
+
+template<typename T>
+int simd_find(const T* first, int n, const T& value)
+{
+  using namespace simdfind_detail;
+#ifdef SIMDFIND_SSE2
+  if constexpr (std::is_integral<T>::value and
+                (sizeof(T) == 1 or sizeof(T) == 2 or sizeof(T) == 4 or sizeof(T) == 8)) {
+#ifdef SIMDFIND_AVX2
+    if (has_avx2())
+      return avx2_find_int(first, n, value);
+#endif
+    return sse2_find_int(first, n, value);
+  }
+  else if constexpr (std::is_same<T, float>::value)
+    return sse2_find_float(first, n, value);
+  else if constexpr (std::is_same<T, double>::value)
+    return sse2_find_double(first, n, value);
+  else
+#endif
+    return scalar_find(first, 0, n, value);
+}
+
+
+#endif
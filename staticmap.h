@@ -0,0 +1,391 @@
+//---------------------------------------------------------------------------
+// NAME: Mason Manca
+// FILE: staticmap.h
+// DATE: Fall 2021
+// DESC: Read-optimized map for lookup tables that are built in bulk
+//       and then queried many times. The keys are stored in
+//       Eytzinger (breadth-first) order: slot k (counting from 1) is
+//       the root of a search tree whose children are slots 2k and
+//       2k + 1. A search walks down from slot 1, so the first few
+//       levels every search touches share a few cache lines, and
+//       the descendants four or so levels down sit next to each
+//       other and are prefetched while the current level is
+//       compared. The step is a conditional add rather than a
+//       branch. Ordered key queries walk the tree in order. Inserts
+//       and erases rebuild the whole layout (O(n)), so they are
+//       meant to be rare.
+//---------------------------------------------------------------------------
+
+#ifndef STATICMAP_H
+#define STATICMAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include "map.h"
+#include "interface.h"
+#include "arrayseq.h"
+#include "binsearchmap.h"
+
+template <typename K, typename V>
+class StaticMap final : public Map<K, V>
+{
+public:
+    // Creates an empty map
+    StaticMap();
+
+    // Builds the map from the pairs of a BinSearchMap
+    template <template <typename> class Seq,
+              template <typename, typename, template <typename> class> class Layout>
+    explicit StaticMap(const BinSearchMap<K, V, Seq, Layout> &m);
+
+    // Builds the map from keys in ascending order (without
+    // duplicates) and their values at the same indexes. Throws
+    // out_of_range if the two sequences differ in length.
+    StaticMap(ArraySeq<K> sorted_keys, ArraySeq<V> sorted_values);
+
+    // Returns the number of key-value pairs in the map
+    int size() const;
+
+    // Tests if the map is empty
+    bool empty() const;
+
+    // Allows values associated with a key to be updated. Throws
+    // out_of_range if the given key is not in the collection.
+    V &operator[](const K &key);
+
+    // Returns the value for a given key. Throws out_of_range if the
+    // given key is not in the collection.
+    const V &operator[](const K &key) const;
+
+    // Extends the collection by adding the given key-value pair (if
+    // the key is not already present). Rebuilds the layout, O(n).
+    void insert(const K &key, const V &value);
+
+    // Same as above, moving the key and value into the collection
+    // instead of copying them.
+    void insert(K &&key, V &&value);
+
+    // Adds the key with a value constructed in place from the
+    // arguments (forwarded to V's constructor) if the key is not
+    // already in the collection. Returns true if the pair was added,
+    // and false (without using the arguments) otherwise. Rebuilds
+    // the layout when a pair is added.
+    template <typename... Args>
+    bool try_emplace(const K &key, Args &&...args);
+    template <typename... Args>
+    bool try_emplace(K &&key, Args &&...args);
+
+    // Shrinks the collection by removing the key-value pair with the
+    // given key. Throws out_of_range if the given key is not in the
+    // collection. Rebuilds the layout, O(n).
+    void erase(const K &key);
+
+    // Returns true if the key is in the collection, and false
+    // otherwise.
+    bool contains(const K &key) const;
+
+    // Returns the keys k in the collection such that k1 <= k <= k2
+    ArraySeq<K> find_keys(const K &k1, const K &k2) const;
+
+    // Returns the keys in the collection in ascending sorted order.
+    ArraySeq<K> sorted_keys() const;
+
+private:
+    // keys in Eytzinger order (slot k is at index k - 1)
+    ArraySeq<K> keys;
+
+    // values in the same order as the keys
+    ArraySeq<V> values;
+
+    // helper for both try_emplace overloads (KArg is const K& or K)
+    template <typename KArg, typename... Args>
+    bool emplace_unique(KArg &&key, Args &&...args);
+
+    // Returns the slot (from 1) of the first key not less than the
+    // given key, or 0 if every key is less
+    int lower_bound(const K &key) const;
+
+    // Returns the slot holding the smallest of n keys (0 if n is 0)
+    static int first_slot(int n);
+
+    // Returns the slot holding the next larger key after the one in
+    // the given slot, out of n keys (0 if it holds the largest)
+    static int next_slot(int slot, int n);
+
+    // Moves the pairs out in ascending key order, leaving the map
+    // empty
+    void unload(ArraySeq<K> &sorted_keys, ArraySeq<V> &sorted_values);
+
+    // Lays out the pairs (in ascending key order) in Eytzinger order
+    void build(ArraySeq<K> &sorted_keys, ArraySeq<V> &sorted_values);
+};
+
+
+// Creates an empty map
+template <typename K, typename V>
+StaticMap<K, V>::StaticMap()
+{
+}
+
+// Builds the map from the (already sorted) keys and values of the
+// BinSearchMap, each copied out in one linear pass
+template <typename K, typename V>
+template <template <typename> class Seq,
+          template <typename, typename, template <typename> class> class Layout>
+StaticMap<K, V>::StaticMap(const BinSearchMap<K, V, Seq, Layout> &m)
+{
+    ArraySeq<K> sorted_keys = m.sorted_keys();
+    ArraySeq<V> sorted_values = m.sorted_values();
+    build(sorted_keys, sorted_values);
+}
+
+// Builds the map from sorted keys and their values
+template <typename K, typename V>
+StaticMap<K, V>::StaticMap(ArraySeq<K> sorted_keys, ArraySeq<V> sorted_values)
+{
+    if (sorted_keys.size() != sorted_values.size())
+        throw std::out_of_range("Out of range in StaticMap, key and value counts differ");
+    build(sorted_keys, sorted_values);
+}
+
+// Returns the number of key-value pairs in the map
+template <typename K, typename V>
+int StaticMap<K, V>::size() const
+{
+    return keys.size();
+}
+
+// Tests if the map is empty
+template <typename K, typename V>
+bool StaticMap<K, V>::empty() const
+{
+    return keys.empty();
+}
+
+// Allows values associated with a key to be updated. Throws
+// out_of_range if the given key is not in the collection.
+template <typename K, typename V>
+V &StaticMap<K, V>::operator[](const K &key)
+{
+    int slot = lower_bound(key);
+    if (slot == 0 or key < keys.at_unchecked(slot - 1))
+        throw std::out_of_range("Out of range in the [] nonconst");
+    return values.at_unchecked(slot - 1);
+}
+
+// Returns the value for a given key. Throws out_of_range if the
+// given key is not in the collection.
+template <typename K, typename V>
+const V &StaticMap<K, V>::operator[](const K &key) const
+{
+    int slot = lower_bound(key);
+    if (slot == 0 or key < keys.at_unchecked(slot - 1))
+        throw std::out_of_range("Out of range in the [] const");
+    return values.at_unchecked(slot - 1);
+}
+
+// Adds the key-value pair (if the key is not present) and rebuilds
+template <typename K, typename V>
+void StaticMap<K, V>::insert(const K &key, const V &value)
+{
+    emplace_unique(key, value);
+}
+
+// Moves the key-value pair in (if the key is not present) and
+// rebuilds
+template <typename K, typename V>
+void StaticMap<K, V>::insert(K &&key, V &&value)
+{
+    emplace_unique(std::move(key), std::move(value));
+}
+
+// Adds the key with a value constructed in place from the arguments
+// if the key is not already in the collection.
+template <typename K, typename V>
+template <typename... Args>
+bool StaticMap<K, V>::try_emplace(const K &key, Args &&...args)
+{
+    return emplace_unique(key, std::forward<Args>(args)...);
+}
+
+template <typename K, typename V>
+template <typename... Args>
+bool StaticMap<K, V>::try_emplace(K &&key, Args &&...args)
+{
+    return emplace_unique(std::move(key), std::forward<Args>(args)...);
+}
+
+// Returns false if the key is in the collection, otherwise unloads
+// the pairs in order, adds the new pair at its sorted index, and
+// rebuilds the layout. The value is constructed before anything is
+// unloaded, since the arguments may refer into the map.
+template <typename K, typename V>
+template <typename KArg, typename... Args>
+bool StaticMap<K, V>::emplace_unique(KArg &&key, Args &&...args)
+{
+    if (contains(key))
+        return false;
+    V value(std::forward<Args>(args)...);
+    K new_key(std::forward<KArg>(key));
+    ArraySeq<K> sorted_keys;
+    ArraySeq<V> sorted_values;
+    unload(sorted_keys, sorted_values);
+    int index = std::lower_bound(sorted_keys.begin(), sorted_keys.end(), new_key) -
+                sorted_keys.begin();
+    sorted_keys.insert(std::move(new_key), index);
+    sorted_values.insert(std::move(value), index);
+    build(sorted_keys, sorted_values);
+    return true;
+}
+
+// Removes the key-value pair with the given key and rebuilds. Throws
+// out_of_range if the given key is not in the collection.
+template <typename K, typename V>
+void StaticMap<K, V>::erase(const K &key)
+{
+    if (!contains(key))
+        throw std::out_of_range("Out of range in erase");
+    ArraySeq<K> sorted_keys;
+    ArraySeq<V> sorted_values;
+    unload(sorted_keys, sorted_values);
+    int index = std::lower_bound(sorted_keys.begin(), sorted_keys.end(), key) -
+                sorted_keys.begin();
+    sorted_keys.erase(index);
+    sorted_values.erase(index);
+    build(sorted_keys, sorted_values);
+}
+
+// Returns true if the key is in the collection, and false
+// otherwise.
+template <typename K, typename V>
+bool StaticMap<K, V>::contains(const K &key) const
+{
+    int slot = lower_bound(key);
+    return slot != 0 and !(key < keys.at_unchecked(slot - 1));
+}
+
+// Returns the keys k in the collection such that k1 <= k <= k2, by
+// walking in order from the first key not less than k1
+template <typename K, typename V>
+ArraySeq<K> StaticMap<K, V>::find_keys(const K &k1, const K &k2) const
+{
+    ArraySeq<K> found;
+    for (int slot = lower_bound(k1);
+         slot != 0 and !(k2 < keys.at_unchecked(slot - 1)); slot = next_slot(slot, keys.size()))
+        found.insert(keys.at_unchecked(slot - 1), found.size());
+    return found;
+}
+
+// Returns the keys in the collection in ascending sorted order.
+template <typename K, typename V>
+ArraySeq<K> StaticMap<K, V>::sorted_keys() const
+{
+    ArraySeq<K> sorted;
+    sorted.reserve(keys.size());
+    for (int slot = first_slot(keys.size()); slot != 0; slot = next_slot(slot, keys.size()))
+        sorted.insert(keys.at_unchecked(slot - 1), sorted.size());
+    return sorted;
+}
+
+// Walks down from the root, going right (2k + 1) past keys less than
+// the given key and left (2k) otherwise, until past the last slot.
+// The slot the walk last went left from is the answer: the trailing
+// one bits of k are the final right turns, so shifting them (and the
+// left turn before them) off gives that slot, or 0 if the walk never
+// went left. The keys 4 levels down (16 slots starting at slot 16k,
+// one or two cache lines for small keys) are prefetched before the
+// current key is compared.
+template <typename K, typename V>
+int StaticMap<K, V>::lower_bound(const K &key) const
+{
+    const K *tree = keys.data();
+    std::ptrdiff_t n = keys.size();
+    std::ptrdiff_t k = 1;
+    while (k <= n)
+    {
+        if (16 * k <= n)
+            __builtin_prefetch(tree + 16 * k - 1);
+        k = 2 * k + (tree[k - 1] < key);
+    }
+    k >>= __builtin_ffsl(~k);
+    return static_cast<int>(k);
+}
+
+// Returns the leftmost slot
+template <typename K, typename V>
+int StaticMap<K, V>::first_slot(int n)
+{
+    if (n == 0)
+        return 0;
+    int slot = 1;
+    while (2 * slot <= n)
+        slot *= 2;
+    return slot;
+}
+
+// Returns the in order successor: the leftmost slot of the right
+// subtree if there is one, otherwise the first ancestor whose left
+// subtree holds the slot
+template <typename K, typename V>
+int StaticMap<K, V>::next_slot(int slot, int n)
+{
+    if (2 * slot + 1 <= n)
+    {
+        slot = 2 * slot + 1;
+        while (2 * slot <= n)
+            slot *= 2;
+        return slot;
+    }
+    while (slot & 1)
+        slot >>= 1;
+    return slot >> 1;
+}
+
+// Moves the pairs out in ascending key order
+template <typename K, typename V>
+void StaticMap<K, V>::unload(ArraySeq<K> &sorted_keys, ArraySeq<V> &sorted_values)
+{
+    sorted_keys.reserve(keys.size());
+    sorted_values.reserve(values.size());
+    for (int slot = first_slot(keys.size()); slot != 0; slot = next_slot(slot, keys.size()))
+    {
+        sorted_keys.insert(std::move(keys.at_unchecked(slot - 1)), sorted_keys.size());
+        sorted_values.insert(std::move(values.at_unchecked(slot - 1)), sorted_values.size());
+    }
+    keys = ArraySeq<K>();
+    values = ArraySeq<V>();
+}
+
+// Numbers the slots with their ranks by an in order walk, then fills
+// the slots in index order, moving each pair from its rank
+template <typename K, typename V>
+void StaticMap<K, V>::build(ArraySeq<K> &sorted_keys, ArraySeq<V> &sorted_values)
+{
+    int n = sorted_keys.size();
+    ArraySeq<int> rank;
+    rank.reserve(n);
+    for (int i = 0; i < n; ++i)
+        rank.insert(0, i);
+    int r = 0;
+    for (int slot = first_slot(n); slot != 0; slot = next_slot(slot, n))
+        rank.at_unchecked(slot - 1) = r++;
+
+    keys = ArraySeq<K>();
+    values = ArraySeq<V>();
+    keys.reserve(n);
+    values.reserve(n);
+    for (int i = 0; i < n; ++i)
+    {
+        keys.insert(std::move(sorted_keys.at_unchecked(rank.at_unchecked(i))), i);
+        values.insert(std::move(sorted_values.at_unchecked(rank.at_unchecked(i))), i);
+    }
+}
+
+
+static_assert(is_map<StaticMap<int, int>, int, int>::value and
+              has_static_dispatch<StaticMap<int, int>>::value,
+              "StaticMap must satisfy the Map interface statically");
+
+#endif
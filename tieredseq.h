@@ -0,0 +1,513 @@
+//---------------------------------------------------------------------------
+// NAME: Mason Manca
+// FILE: tieredseq.h
+// DATE: Fall 2021
+// DESC: Tiered vector implementation of Sequence. Elements are stored
+//       in equal sized chunks, each a circular buffer, where every
+//       chunk except the last is full. Element i is in chunk i / width
+//       at offset (head of chunk + i) % width, so access is O(1) with
+//       a shift and a mask. An insert or erase shifts elements within
+//       one chunk and rotates each following chunk by one (moving a
+//       single element between neighbors), so it costs O(width +
+//       count / width). The chunk width is a power of two kept near
+//       sqrt(2 * count), making both O(sqrt n).
+//---------------------------------------------------------------------------
+
+#ifndef TIEREDSEQ_H
+#define TIEREDSEQ_H
+
+#include <stdexcept>
+#include <ostream>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#include "sequence.h"
+#include "arrayseq.h"
+#include "indexiterator.h"
+#include "interface.h"
+
+
+template<typename T>
+class TieredSeq final : public Sequence<T>
+{
+public:
+
+  // Random access iterators over the elements (by index)
+  using iterator = IndexIterator<TieredSeq*, T&>;
+  using const_iterator = IndexIterator<const TieredSeq*, const T&>;
+
+  // Default constructor
+  TieredSeq();
+
+  // Copy constructor
+  TieredSeq(const TieredSeq& rhs);
+
+  // Move constructor
+  TieredSeq(TieredSeq&& rhs);
+
+  // Copy assignment operator
+  TieredSeq& operator=(const TieredSeq& rhs);
+
+  // Move assignment operator
+  TieredSeq& operator=(TieredSeq&& rhs);
+
+  // Destructor
+  ~TieredSeq();
+
+  // Returns the number of elements in the sequence
+  int size() const;
+
+  // Tests if the sequence is empty
+  bool empty() const;
+
+  // Returns a reference to the element at the index in the
+  // sequence. Throws out_of_range if index is invalid.
+  T& operator[](int index);
+
+  // Returns a constant address to the element at the index in the
+  // sequence. Throws out_of_range if index is invalid.
+  const T& operator[](int index) const;
+
+  // Returns the element at the index without checking the index.
+  // The index must be valid.
+  T& at_unchecked(int index);
+  const T& at_unchecked(int index) const;
+
+  // Extends the sequence by inserting the element at the given
+  // index. Throws out_of_range if the index is invalid.
+  void insert(const T& elem, int index);
+
+  // Same as above, moving the element into the sequence instead of
+  // copying it.
+  void insert(T&& elem, int index);
+
+  // Extends the sequence by constructing an element at the given
+  // index from the arguments (forwarded to T's constructor), and
+  // returns a reference to it. Throws out_of_range if the index is
+  // invalid.
+  template<typename... Args>
+  T& emplace(int index, Args&&... args);
+
+  // Shrinks the sequence by removing the element at the index in the
+  // sequence. Throws out_of_range if index is invalid.
+  void erase(int index);
+
+  // Returns true if the element is in the sequence, and false
+  // otherwise.
+  bool contains(const T& elem) const;
+
+  // Grows the storage (if needed) so that it can hold at least n
+  // elements without reallocating.
+  void reserve(int n);
+
+  // Sorts the elements in the sequence using less than (<), by
+  // sorting them in an ArraySeq and moving them back.
+  void sort();
+
+  // Iterators over the elements
+  iterator begin();
+  iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
+
+private:
+
+  // smallest chunk width
+  static const int min_width = 16;
+
+  // raw storage for chunks * width elements (chunk c is the slots
+  // [c * width, (c + 1) * width))
+  T* slots = nullptr;
+
+  // offset of the first element of each chunk within the chunk
+  int* heads = nullptr;
+
+  // number of chunks, elements per chunk (a power of two), and
+  // log2(width)
+  int chunks = 0;
+  int width = min_width;
+  int shift = 4;
+
+  // number of elements
+  int count = 0;
+
+  // helper to return the element at the given position of a chunk
+  T& slot(int chunk, int pos) const;
+
+  // helper to move the elements into new storage with the given
+  // chunk width and number of chunks (all chunk heads reset to 0)
+  void rebuild(int new_width, int new_chunks);
+
+  // helper to grow the storage so it can hold n elements, widening
+  // the chunks to keep the width near sqrt(2 * n)
+  void grow_to(int n);
+
+  // helper to destroy the elements and free the storage
+  void make_empty();
+
+};
+
+
+template<typename T>
+std::ostream& operator<<(std::ostream& stream, const TieredSeq<T>& seq)
+{
+  for(int i = 0; i < seq.size(); ++i)
+  {
+    if(i > 0)
+      stream << ", ";
+    stream << seq.at_unchecked(i);
+  }
+  return stream;
+}
+
+
+// Default constructor
+template<typename T>
+TieredSeq<T>::TieredSeq()
+{
+}
+
+// Copy constructor
+template<typename T>
+TieredSeq<T>::TieredSeq(const TieredSeq& rhs)
+{
+  *this = rhs;
+}
+
+// Move constructor
+template<typename T>
+TieredSeq<T>::TieredSeq(TieredSeq&& rhs)
+{
+  *this = std::move(rhs);
+}
+
+// Copy assignment operator
+template<typename T>
+TieredSeq<T>& TieredSeq<T>::operator=(const TieredSeq& rhs)
+{
+  if(this != &rhs)
+  {
+    make_empty();
+    reserve(rhs.count);
+    for(int i = 0; i < rhs.count; ++i)
+      emplace(count, rhs.at_unchecked(i));
+  }
+  return *this;
+}
+
+// Move assignment operator
+template<typename T>
+TieredSeq<T>& TieredSeq<T>::operator=(TieredSeq&& rhs)
+{
+  if(this != &rhs)
+  {
+    make_empty();
+    slots = rhs.slots;
+    heads = rhs.heads;
+    chunks = rhs.chunks;
+    width = rhs.width;
+    shift = rhs.shift;
+    count = rhs.count;
+    rhs.slots = nullptr;
+    rhs.heads = nullptr;
+    rhs.chunks = rhs.count = 0;
+    rhs.width = min_width;
+    rhs.shift = 4;
+  }
+  return *this;
+}
+
+// Destructor
+template<typename T>
+TieredSeq<T>::~TieredSeq()
+{
+  make_empty();
+}
+
+// Returns the number of elements in the sequence
+template<typename T>
+int TieredSeq<T>::size() const
+{
+  return count;
+}
+
+// Tests if the sequence is empty
+template<typename T>
+bool TieredSeq<T>::empty() const
+{
+  return count == 0;
+}
+
+// Returns a reference to the element at the index in the sequence.
+// Throws out_of_range if index is invalid.
+template<typename T>
+T& TieredSeq<T>::operator[](int index)
+{
+  if(index >= count or index < 0)
+    throw std::out_of_range("Out of range in the [] nonconst");
+  return at_unchecked(index);
+}
+
+// Returns a constant address to the element at the index in the
+// sequence. Throws out_of_range if index is invalid.
+template<typename T>
+const T& TieredSeq<T>::operator[](int index) const
+{
+  if(index >= count or index < 0)
+    throw std::out_of_range("Out of range in the [] const");
+  return at_unchecked(index);
+}
+
+// Returns the element at the index without checking the index
+template<typename T>
+T& TieredSeq<T>::at_unchecked(int index)
+{
+  return slot(index >> shift, index & (width - 1));
+}
+
+template<typename T>
+const T& TieredSeq<T>::at_unchecked(int index) const
+{
+  return slot(index >> shift, index & (width - 1));
+}
+
+// Extends the sequence by inserting the element at the given index.
+// Throws out_of_range if the index is invalid.
+template<typename T>
+void TieredSeq<T>::insert(const T& elem, int index)
+{
+  emplace(index, elem);
+}
+
+// Extends the sequence by moving the element in at the given index.
+// Throws out_of_range if the index is invalid.
+template<typename T>
+void TieredSeq<T>::insert(T&& elem, int index)
+{
+  emplace(index, std::move(elem));
+}
+
+// Constructs an element at the given index. Each full chunk after the
+// index's chunk passes its last element to the front of the next
+// chunk (by moving its head back one slot), then the index's chunk
+// shifts the elements after the index over by one. Throws
+// out_of_range if the index is invalid.
+template<typename T>
+template<typename... Args>
+T& TieredSeq<T>::emplace(int index, Args&&... args)
+{
+  if(index > count or index < 0)
+    throw std::out_of_range("Out of range in insert");
+
+  // the arguments may refer into the sequence, which the moves below
+  // would invalidate, so the element is built first
+  T elem(std::forward<Args>(args)...);
+  if(count == chunks * width)
+    grow_to(count + 1);
+
+  const int mask = width - 1;
+  int chunk = index >> shift;
+  int pos = index & mask;
+  int last = count >> shift;
+  int used = count & mask;
+
+  if(chunk == last)
+  {
+    // the last chunk has room, shift within it
+    if(pos == used)
+      new (&slot(last, pos)) T(std::move(elem));
+    else
+    {
+      new (&slot(last, used)) T(std::move(slot(last, used - 1)));
+      for(int p = used - 1; p > pos; --p)
+        slot(last, p) = std::move(slot(last, p - 1));
+      slot(last, pos) = std::move(elem);
+    }
+  }
+  else
+  {
+    // the last chunk gets a new front slot for the previous chunk's
+    // last element
+    heads[last] = (heads[last] - 1) & mask;
+    new (&slot(last, 0)) T(std::move(slot(last - 1, mask)));
+    // each full chunk in between rotates its (moved from) last slot
+    // to the front and takes the previous chunk's last element
+    for(int c = last - 1; c > chunk; --c)
+    {
+      heads[c] = (heads[c] - 1) & mask;
+      slot(c, 0) = std::move(slot(c - 1, mask));
+    }
+    for(int p = mask; p > pos; --p)
+      slot(chunk, p) = std::move(slot(chunk, p - 1));
+    slot(chunk, pos) = std::move(elem);
+  }
+  ++count;
+  return slot(chunk, pos);
+}
+
+// Shrinks the sequence by removing the element at the index. The
+// reverse of emplace: the index's chunk shifts left over the index
+// and takes the next chunk's first element, and so on to the last
+// chunk. Throws out_of_range if index is invalid.
+template<typename T>
+void TieredSeq<T>::erase(int index)
+{
+  if(index >= count or index < 0)
+    throw std::out_of_range("Out of range in erase");
+
+  const int mask = width - 1;
+  int chunk = index >> shift;
+  int pos = index & mask;
+  int last = (count - 1) >> shift;
+
+  if(chunk == last)
+  {
+    int used = count - (last << shift);
+    for(int p = pos; p < used - 1; ++p)
+      slot(last, p) = std::move(slot(last, p + 1));
+    std::destroy_at(&slot(last, used - 1));
+  }
+  else
+  {
+    for(int p = pos; p < mask; ++p)
+      slot(chunk, p) = std::move(slot(chunk, p + 1));
+    slot(chunk, mask) = std::move(slot(chunk + 1, 0));
+    // each full chunk in between rotates its (moved from) first slot
+    // to the back and takes the next chunk's first element
+    for(int c = chunk + 1; c < last; ++c)
+    {
+      heads[c] = (heads[c] + 1) & mask;
+      slot(c, mask) = std::move(slot(c + 1, 0));
+    }
+    std::destroy_at(&slot(last, 0));
+    heads[last] = (heads[last] + 1) & mask;
+  }
+  --count;
+}
+
+// Returns true if the element is in the sequence, and false
+// otherwise.
+template<typename T>
+bool TieredSeq<T>::contains(const T& elem) const
+{
+  for(int i = 0; i < count; ++i)
+    if(at_unchecked(i) == elem)
+      return true;
+  return false;
+}
+
+// Grows the storage to hold at least n elements
+template<typename T>
+void TieredSeq<T>::reserve(int n)
+{
+  if(n > chunks * width)
+    grow_to(n);
+}
+
+// Sorts by moving the elements into an ArraySeq (which picks radix
+// sort or introsort), sorting, and moving them back in order
+template<typename T>
+void TieredSeq<T>::sort()
+{
+  if(count < 2)
+    return;
+  ArraySeq<T> sorted;
+  sorted.reserve(count);
+  for(int i = 0; i < count; ++i)
+    sorted.insert(std::move(at_unchecked(i)), i);
+  sorted.sort();
+  for(int i = 0; i < count; ++i)
+    at_unchecked(i) = std::move(sorted.at_unchecked(i));
+}
+
+// Iterators over the elements
+template<typename T>
+typename TieredSeq<T>::iterator TieredSeq<T>::begin()
+{
+  return iterator(this, 0);
+}
+
+template<typename T>
+typename TieredSeq<T>::iterator TieredSeq<T>::end()
+{
+  return iterator(this, count);
+}
+
+template<typename T>
+typename TieredSeq<T>::const_iterator TieredSeq<T>::begin() const
+{
+  return const_iterator(this, 0);
+}
+
+template<typename T>
+typename TieredSeq<T>::const_iterator TieredSeq<T>::end() const
+{
+  return const_iterator(this, count);
+}
+
+// Returns the element at the position of the chunk
+template<typename T>
+T& TieredSeq<T>::slot(int chunk, int pos) const
+{
+  return slots[(chunk << shift) + ((heads[chunk] + pos) & (width - 1))];
+}
+
+// Moves the elements in order into new storage
+template<typename T>
+void TieredSeq<T>::rebuild(int new_width, int new_chunks)
+{
+  T* new_slots = std::allocator<T>().allocate(new_width * new_chunks);
+  int* new_heads = new int[new_chunks]();
+  for(int i = 0; i < count; ++i)
+  {
+    T& elem = at_unchecked(i);
+    new (new_slots + i) T(std::move(elem));
+    std::destroy_at(&elem);
+  }
+  if(slots != nullptr)
+    std::allocator<T>().deallocate(slots, chunks * width);
+  delete [] heads;
+  slots = new_slots;
+  heads = new_heads;
+  chunks = new_chunks;
+  width = new_width;
+  shift = 0;
+  while((1 << shift) < width)
+    ++shift;
+}
+
+// Grows the storage to at least twice its size (and at least n),
+// doubling the chunk width until width * width >= 2 * n
+template<typename T>
+void TieredSeq<T>::grow_to(int n)
+{
+  n = std::max(n, 2 * chunks * width);
+  int new_width = width;
+  while((long) new_width * new_width < 2L * n)
+    new_width *= 2;
+  rebuild(new_width, (n + new_width - 1) / new_width);
+}
+
+// Destroys the elements and frees the storage
+template<typename T>
+void TieredSeq<T>::make_empty()
+{
+  for(int i = 0; i < count; ++i)
+    std::destroy_at(&at_unchecked(i));
+  if(slots != nullptr)
+    std::allocator<T>().deallocate(slots, chunks * width);
+  delete [] heads;
+  slots = nullptr;
+  heads = nullptr;
+  chunks = 0;
+  count = 0;
+}
+
+static_assert(is_sequence<TieredSeq<int>, int>::value and
+              has_static_dispatch<TieredSeq<int>>::value,
+              "TieredSeq must satisfy the Sequence interface statically");
+
+
+#endif
@@ -0,0 +1,569 @@
+//---------------------------------------------------------------------------
+// NAME: Mason Manca
+// FILE: treemap.h
+// DATE: Fall 2021
+// DESC: AVL tree implementation of Map. Each node holds one key-value
+//       pair and the height of its subtree; after an insert or erase
+//       the nodes on the path are rebalanced with rotations so that
+//       sibling subtrees differ in height by at most one, keeping
+//       every operation O(log n). Rotations and erases only relink
+//       nodes, so a pair never moves once it is in the tree. Nodes
+//       come from the map's own NodePool (see nodepool.h), so nodes
+//       added together sit together in memory and destroying the map
+//       frees a few slabs instead of every node.
+//---------------------------------------------------------------------------
+
+#ifndef TREEMAP_H
+#define TREEMAP_H
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "map.h"
+#include "interface.h"
+#include "arrayseq.h"
+#include "nodepool.h"
+
+template <typename K, typename V>
+class TreeMap final : public Map<K, V>
+{
+public:
+    // Default constructor
+    TreeMap();
+
+    // Copy constructor
+    TreeMap(const TreeMap &rhs);
+
+    // Move constructor
+    TreeMap(TreeMap &&rhs);
+
+    // Copy assignment operator
+    TreeMap &operator=(const TreeMap &rhs);
+
+    // Move assignment operator
+    TreeMap &operator=(TreeMap &&rhs);
+
+    // Destructor
+    ~TreeMap();
+
+    // Returns the number of key-value pairs in the map
+    int size() const;
+
+    // Tests if the map is empty
+    bool empty() const;
+
+    // Allows values associated with a key to be updated. Throws
+    // out_of_range if the given key is not in the collection.
+    V &operator[](const K &key);
+
+    // Returns the value for a given key. Throws out_of_range if the
+    // given key is not in the collection.
+    const V &operator[](const K &key) const;
+
+    // Extends the collection by adding the given key-value pair (if
+    // the key is not already present).
+    void insert(const K &key, const V &value);
+
+    // Same as above, moving the key and value into the collection
+    // instead of copying them.
+    void insert(K &&key, V &&value);
+
+    // Adds the key with a value constructed in place from the
+    // arguments (forwarded to V's constructor) if the key is not
+    // already in the collection. Returns true if the pair was added,
+    // and false (without using the arguments) otherwise.
+    template <typename... Args>
+    bool try_emplace(const K &key, Args &&...args);
+    template <typename... Args>
+    bool try_emplace(K &&key, Args &&...args);
+
+    // Shrinks the collection by removing the key-value pair with the
+    // given key. Throws out_of_range if the given key is not in the
+    // collection.
+    void erase(const K &key);
+
+    // Returns true if the key is in the collection, and false
+    // otherwise.
+    bool contains(const K &key) const;
+
+    // Returns the keys k in the collection such that k1 <= k <= k2
+    ArraySeq<K> find_keys(const K &k1, const K &k2) const;
+
+    // Returns the keys in the collection in ascending sorted order.
+    ArraySeq<K> sorted_keys() const;
+
+private:
+    // tree node (a leaf has height 1, an empty subtree height 0)
+    struct Node
+    {
+        K key;
+        V value;
+        Node *left;
+        Node *right;
+        int height;
+    };
+
+    // the root (null when the map is empty)
+    Node *root = nullptr;
+
+    // number of pairs
+    int count = 0;
+
+    // node storage
+    NodePool<Node> nodes;
+
+    // helper to return the node with the key, or null
+    Node *find(const K &key) const;
+
+    // helpers for the height and balance (left height minus right
+    // height) of a subtree
+    static int height_of(const Node *node);
+    static int balance_of(const Node *node);
+
+    // helper to recompute the node's height from its children
+    static void update(Node *node);
+
+    // helpers to rotate the subtree and return its new root
+    static Node *rotate_left(Node *node);
+    static Node *rotate_right(Node *node);
+
+    // helper to restore the AVL balance at the node (whose subtrees
+    // are balanced and differ in height by at most two) and return
+    // the subtree's new root
+    static Node *rebalance(Node *node);
+
+    // helper to add the key (with a value built from the arguments) to
+    // the subtree if it is not there, setting added, and return the
+    // subtree's new root
+    template <typename KArg, typename... Args>
+    Node *insert_at(Node *node, bool &added, KArg &&key, Args &&...args);
+
+    // helper to unlink the node with the key from the subtree, setting
+    // removed to it (null if the key is not there), and return the
+    // subtree's new root
+    Node *erase_at(Node *node, const K &key, Node *&removed);
+
+    // helper to unlink the smallest node of the subtree, setting min
+    // to it, and return the subtree's new root
+    Node *unlink_min(Node *node, Node *&min);
+
+    // helper for both try_emplace overloads (KArg is const K& or K)
+    template <typename KArg, typename... Args>
+    bool emplace_unique(KArg &&key, Args &&...args);
+
+    // helpers to append the subtree's keys in order (all of them, or
+    // those in [k1, k2])
+    static void collect(const Node *node, ArraySeq<K> &keys);
+    static void collect(const Node *node, const K &k1, const K &k2, ArraySeq<K> &keys);
+
+    // helper to copy a subtree (same shape) into this map's pool
+    Node *clone(const Node *node);
+
+    // helper to destroy the pairs of a subtree
+    static void destroy(Node *node);
+
+    // helper to destroy the pairs and release the nodes
+    void make_empty();
+};
+
+
+// Default constructor
+template <typename K, typename V>
+TreeMap<K, V>::TreeMap()
+{
+}
+
+// Copy constructor
+template <typename K, typename V>
+TreeMap<K, V>::TreeMap(const TreeMap &rhs)
+{
+    *this = rhs;
+}
+
+// Move constructor
+template <typename K, typename V>
+TreeMap<K, V>::TreeMap(TreeMap &&rhs)
+{
+    *this = std::move(rhs);
+}
+
+// Copy assignment operator, copying the tree node by node
+template <typename K, typename V>
+TreeMap<K, V> &TreeMap<K, V>::operator=(const TreeMap &rhs)
+{
+    if (this != &rhs)
+    {
+        make_empty();
+        nodes.reserve(rhs.count);
+        root = clone(rhs.root);
+        count = rhs.count;
+    }
+    return *this;
+}
+
+// Move assignment operator
+template <typename K, typename V>
+TreeMap<K, V> &TreeMap<K, V>::operator=(TreeMap &&rhs)
+{
+    if (this != &rhs)
+    {
+        make_empty();
+        root = rhs.root;
+        count = rhs.count;
+        nodes = std::move(rhs.nodes);
+        rhs.root = nullptr;
+        rhs.count = 0;
+    }
+    return *this;
+}
+
+// Destructor
+template <typename K, typename V>
+TreeMap<K, V>::~TreeMap()
+{
+    make_empty();
+}
+
+// Returns the number of key-value pairs in the map
+template <typename K, typename V>
+int TreeMap<K, V>::size() const
+{
+    return count;
+}
+
+// Tests if the map is empty
+template <typename K, typename V>
+bool TreeMap<K, V>::empty() const
+{
+    return count == 0;
+}
+
+// Allows values associated with a key to be updated. Throws
+// out_of_range if the given key is not in the collection.
+template <typename K, typename V>
+V &TreeMap<K, V>::operator[](const K &key)
+{
+    Node *node = find(key);
+    if (node == nullptr)
+        throw std::out_of_range("Out of range in the [] nonconst");
+    return node->value;
+}
+
+// Returns the value for a given key. Throws out_of_range if the
+// given key is not in the collection.
+template <typename K, typename V>
+const V &TreeMap<K, V>::operator[](const K &key) const
+{
+    Node *node = find(key);
+    if (node == nullptr)
+        throw std::out_of_range("Out of range in the [] const");
+    return node->value;
+}
+
+// Extends the collection by adding the given key-value pair
+template <typename K, typename V>
+void TreeMap<K, V>::insert(const K &key, const V &value)
+{
+    emplace_unique(key, value);
+}
+
+// Extends the collection by moving the given key-value pair in
+template <typename K, typename V>
+void TreeMap<K, V>::insert(K &&key, V &&value)
+{
+    emplace_unique(std::move(key), std::move(value));
+}
+
+// Adds the key with a value constructed in place from the arguments
+// if the key is not already in the collection.
+template <typename K, typename V>
+template <typename... Args>
+bool TreeMap<K, V>::try_emplace(const K &key, Args &&...args)
+{
+    return emplace_unique(key, std::forward<Args>(args)...);
+}
+
+template <typename K, typename V>
+template <typename... Args>
+bool TreeMap<K, V>::try_emplace(K &&key, Args &&...args)
+{
+    return emplace_unique(std::move(key), std::forward<Args>(args)...);
+}
+
+// Returns false if the key is in the collection, otherwise adds the
+// key (forwarded) with a value constructed from the arguments
+template <typename K, typename V>
+template <typename KArg, typename... Args>
+bool TreeMap<K, V>::emplace_unique(KArg &&key, Args &&...args)
+{
+    bool added = false;
+    root = insert_at(root, added, std::forward<KArg>(key), std::forward<Args>(args)...);
+    if (added)
+        ++count;
+    return added;
+}
+
+// Shrinks the collection by removing the key-value pair with the
+// given key. Throws out_of_range if the given key is not in the
+// collection.
+template <typename K, typename V>
+void TreeMap<K, V>::erase(const K &key)
+{
+    Node *removed = nullptr;
+    root = erase_at(root, key, removed);
+    if (removed == nullptr)
+        throw std::out_of_range("Out of range in erase");
+    std::destroy_at(removed);
+    nodes.deallocate(removed);
+    --count;
+}
+
+// Returns true if the key is in the collection, and false
+// otherwise.
+template <typename K, typename V>
+bool TreeMap<K, V>::contains(const K &key) const
+{
+    return find(key) != nullptr;
+}
+
+// Returns the keys k in the collection such that k1 <= k <= k2
+template <typename K, typename V>
+ArraySeq<K> TreeMap<K, V>::find_keys(const K &k1, const K &k2) const
+{
+    ArraySeq<K> keys;
+    collect(root, k1, k2, keys);
+    return keys;
+}
+
+// Returns the keys in the collection in ascending sorted order.
+template <typename K, typename V>
+ArraySeq<K> TreeMap<K, V>::sorted_keys() const
+{
+    ArraySeq<K> keys;
+    keys.reserve(count);
+    collect(root, keys);
+    return keys;
+}
+
+// Walks down from the root to the key
+template <typename K, typename V>
+typename TreeMap<K, V>::Node *TreeMap<K, V>::find(const K &key) const
+{
+    Node *node = root;
+    while (node != nullptr)
+    {
+        if (key < node->key)
+            node = node->left;
+        else if (node->key < key)
+            node = node->right;
+        else
+            return node;
+    }
+    return nullptr;
+}
+
+// Returns the height of the subtree (0 if empty)
+template <typename K, typename V>
+int TreeMap<K, V>::height_of(const Node *node)
+{
+    return node == nullptr ? 0 : node->height;
+}
+
+// Returns the left subtree's height minus the right subtree's
+template <typename K, typename V>
+int TreeMap<K, V>::balance_of(const Node *node)
+{
+    return height_of(node->left) - height_of(node->right);
+}
+
+// Recomputes the node's height from its children
+template <typename K, typename V>
+void TreeMap<K, V>::update(Node *node)
+{
+    node->height = 1 + std::max(height_of(node->left), height_of(node->right));
+}
+
+// Makes the right child the subtree's root
+template <typename K, typename V>
+typename TreeMap<K, V>::Node *TreeMap<K, V>::rotate_left(Node *node)
+{
+    Node *right = node->right;
+    node->right = right->left;
+    right->left = node;
+    update(node);
+    update(right);
+    return right;
+}
+
+// Makes the left child the subtree's root
+template <typename K, typename V>
+typename TreeMap<K, V>::Node *TreeMap<K, V>::rotate_right(Node *node)
+{
+    Node *left = node->left;
+    node->left = left->right;
+    left->right = node;
+    update(node);
+    update(left);
+    return left;
+}
+
+// Rotates once if the taller child leans the same way as the node,
+// and twice (child first) if it leans the other way
+template <typename K, typename V>
+typename TreeMap<K, V>::Node *TreeMap<K, V>::rebalance(Node *node)
+{
+    update(node);
+    int balance = balance_of(node);
+    if (balance > 1)
+    {
+        if (balance_of(node->left) < 0)
+            node->left = rotate_left(node->left);
+        return rotate_right(node);
+    }
+    if (balance < -1)
+    {
+        if (balance_of(node->right) > 0)
+            node->right = rotate_right(node->right);
+        return rotate_left(node);
+    }
+    return node;
+}
+
+// Goes down to where the key belongs, adds a leaf there (unless the
+// key is found on the way), and rebalances on the way back up
+template <typename K, typename V>
+template <typename KArg, typename... Args>
+typename TreeMap<K, V>::Node *
+TreeMap<K, V>::insert_at(Node *node, bool &added, KArg &&key, Args &&...args)
+{
+    if (node == nullptr)
+    {
+        added = true;
+        return new (nodes.allocate())
+            Node{K(std::forward<KArg>(key)), V(std::forward<Args>(args)...), nullptr, nullptr, 1};
+    }
+    if (key < node->key)
+        node->left = insert_at(node->left, added, std::forward<KArg>(key),
+                               std::forward<Args>(args)...);
+    else if (node->key < key)
+        node->right = insert_at(node->right, added, std::forward<KArg>(key),
+                                std::forward<Args>(args)...);
+    else
+        return node;
+    return added ? rebalance(node) : node;
+}
+
+// Goes down to the key. A node with at most one child is replaced by
+// that child; otherwise the smallest node of its right subtree is
+// unlinked and takes its place. Rebalances on the way back up.
+template <typename K, typename V>
+typename TreeMap<K, V>::Node *
+TreeMap<K, V>::erase_at(Node *node, const K &key, Node *&removed)
+{
+    if (node == nullptr)
+        return nullptr;
+    if (key < node->key)
+        node->left = erase_at(node->left, key, removed);
+    else if (node->key < key)
+        node->right = erase_at(node->right, key, removed);
+    else
+    {
+        removed = node;
+        if (node->left == nullptr)
+            return node->right;
+        if (node->right == nullptr)
+            return node->left;
+        Node *min = nullptr;
+        Node *right = unlink_min(node->right, min);
+        min->left = node->left;
+        min->right = right;
+        node = min;
+    }
+    return removed != nullptr ? rebalance(node) : node;
+}
+
+// Goes left to the smallest node, replaces it by its right child,
+// and rebalances on the way back up
+template <typename K, typename V>
+typename TreeMap<K, V>::Node *TreeMap<K, V>::unlink_min(Node *node, Node *&min)
+{
+    if (node->left == nullptr)
+    {
+        min = node;
+        return node->right;
+    }
+    node->left = unlink_min(node->left, min);
+    return rebalance(node);
+}
+
+// Appends the subtree's keys in order
+template <typename K, typename V>
+void TreeMap<K, V>::collect(const Node *node, ArraySeq<K> &keys)
+{
+    if (node == nullptr)
+        return;
+    collect(node->left, keys);
+    keys.insert(node->key, keys.size());
+    collect(node->right, keys);
+}
+
+// Appends the subtree's keys in [k1, k2] in order, skipping subtrees
+// that are entirely outside the range
+template <typename K, typename V>
+void TreeMap<K, V>::collect(const Node *node, const K &k1, const K &k2, ArraySeq<K> &keys)
+{
+    if (node == nullptr)
+        return;
+    if (k1 < node->key)
+        collect(node->left, k1, k2, keys);
+    if (!(node->key < k1) and !(k2 < node->key))
+        keys.insert(node->key, keys.size());
+    if (node->key < k2)
+        collect(node->right, k1, k2, keys);
+}
+
+// Copies the subtree in preorder, so parents are allocated before
+// their children
+template <typename K, typename V>
+typename TreeMap<K, V>::Node *TreeMap<K, V>::clone(const Node *node)
+{
+    if (node == nullptr)
+        return nullptr;
+    Node *copy = new (nodes.allocate())
+        Node{node->key, node->value, nullptr, nullptr, node->height};
+    copy->left = clone(node->left);
+    copy->right = clone(node->right);
+    return copy;
+}
+
+// Destroys the pairs of the subtree (the pool frees the storage)
+template <typename K, typename V>
+void TreeMap<K, V>::destroy(Node *node)
+{
+    if (node == nullptr)
+        return;
+    destroy(node->left);
+    destroy(node->right);
+    std::destroy_at(node);
+}
+
+// Destroys the pairs (skipped when they need no destructor) and
+// releases the pool's slabs all at once
+template <typename K, typename V>
+void TreeMap<K, V>::make_empty()
+{
+    if constexpr (!std::is_trivially_destructible<Node>::value)
+        destroy(root);
+    nodes = NodePool<Node>();
+    root = nullptr;
+    count = 0;
+}
+
+static_assert(is_map<TreeMap<int, int>, int, int>::value and
+              has_static_dispatch<TreeMap<int, int>>::value,
+              "TreeMap must satisfy the Map interface statically");
+
+#endif
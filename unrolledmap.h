@@ -0,0 +1,24 @@
+//---------------------------------------------------------------------------
+// NAME: Mason Manca
+// FILE: unrolledmap.h
+// DATE: Fall 2021
+// DESC: Map implemented as an unrolled linked list of key-value pairs
+//       (LinkedMap over UnrolledSeq). Same operations and costs as
+//       LinkedMap, but scans walk small arrays of pairs instead of
+//       one node per pair.
+//---------------------------------------------------------------------------
+
+#ifndef UNROLLEDMAP_H
+#define UNROLLEDMAP_H
+
+#include "linkedmap.h"
+#include "unrolledseq.h"
+
+template <typename K, typename V>
+using UnrolledMap = LinkedMap<K, V, UnrolledSeq64>;
+
+static_assert(is_map<UnrolledMap<int, int>, int, int>::value and
+              has_static_dispatch<UnrolledMap<int, int>>::value,
+              "UnrolledMap must satisfy the Map interface statically");
+
+#endif
@@ -0,0 +1,647 @@
+//---------------------------------------------------------------------------
+// NAME: Mason Manca
+// FILE: unrolledseq.h
+// DATE: Fall 2021
+// DESC: Unrolled linked list implementation of Sequence. Each node
+//       holds up to NodeCap elements in a small array, so scans touch
+//       far fewer nodes than a one element per node list, and an
+//       insert or erase only shifts the elements of one node. Full
+//       nodes are split in half on insert and nearly empty nodes are
+//       merged with their successor on erase. Nodes come from a
+//       NodePool (see nodepool.h).
+//---------------------------------------------------------------------------
+
+#ifndef UNROLLEDSEQ_H
+#define UNROLLEDSEQ_H
+
+#include <stdexcept>
+#include <ostream>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#include "sequence.h"
+#include "nodepool.h"
+#include "arrayseq.h"
+#include "interface.h"
+
+
+template<typename T, int NodeCap = 64>
+class UnrolledSeq final : public Sequence<T>
+{
+private:
+
+  static_assert(NodeCap >= 4, "UnrolledSeq nodes must hold at least 4 elements");
+
+  // list node holding up to NodeCap elements (only the first count
+  // are constructed)
+  struct Node
+  {
+    Node* prev;
+    Node* next;
+    int count;
+    alignas(T) unsigned char storage[NodeCap * sizeof(T)];
+
+    T* items() { return reinterpret_cast<T*>(storage); }
+  };
+
+public:
+
+  // Forward iterator over the elements (from head to tail)
+  template<typename Ref>
+  class Iterator
+  {
+  public:
+
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = typename std::remove_reference<Ref>::type*;
+    using reference = Ref;
+    using iterator_category = std::forward_iterator_tag;
+
+    Iterator() = default;
+    Iterator(Node* node, int offset) : node(node), offset(offset) {}
+
+    reference operator*() const { return node->items()[offset]; }
+    pointer operator->() const { return node->items() + offset; }
+
+    Iterator& operator++()
+    {
+      if(++offset == node->count)
+      {
+        node = node->next;
+        offset = 0;
+      }
+      return *this;
+    }
+    Iterator operator++(int) { Iterator tmp = *this; ++*this; return tmp; }
+
+    bool operator==(const Iterator& rhs) const
+    { return node == rhs.node and offset == rhs.offset; }
+    bool operator!=(const Iterator& rhs) const { return not (*this == rhs); }
+
+  private:
+
+    // the sequence erases through iterators
+    friend class UnrolledSeq;
+
+    // current node (nullptr past the tail) and index within it
+    Node* node = nullptr;
+    int offset = 0;
+  };
+
+  using iterator = Iterator<T&>;
+  using const_iterator = Iterator<const T&>;
+
+  // Default constructor
+  UnrolledSeq();
+
+  // Copy constructor
+  UnrolledSeq(const UnrolledSeq& rhs);
+
+  // Move constructor
+  UnrolledSeq(UnrolledSeq&& rhs);
+
+  // Copy assignment operator
+  UnrolledSeq& operator=(const UnrolledSeq& rhs);
+
+  // Move assignment operator
+  UnrolledSeq& operator=(UnrolledSeq&& rhs);
+
+  // Destructor
+  ~UnrolledSeq();
+
+  // Returns the number of elements in the sequence
+  int size() const;
+
+  // Tests if the sequence is empty
+  bool empty() const;
+
+  // Returns a reference to the element at the index in the
+  // sequence. Throws out_of_range if index is invalid.
+  T& operator[](int index);
+
+  // Returns a constant address to the element at the index in the
+  // sequence. Throws out_of_range if index is invalid.
+  const T& operator[](int index) const;
+
+  // Extends the sequence by inserting the element at the given
+  // index. Throws out_of_range if the index is invalid.
+  void insert(const T& elem, int index);
+
+  // Same as above, moving the element into the sequence instead of
+  // copying it.
+  void insert(T&& elem, int index);
+
+  // Extends the sequence by constructing an element at the given
+  // index from the arguments (forwarded to T's constructor), and
+  // returns a reference to it. Throws out_of_range if the index is
+  // invalid.
+  template<typename... Args>
+  T& emplace(int index, Args&&... args);
+
+  // Shrinks the sequence by removing the element at the index in the
+  // sequence. Throws out_of_range if index is invalid.
+  void erase(int index);
+
+  // Removes the element at the iterator (which must refer to an
+  // element of this sequence) and returns an iterator to the element
+  // after it.
+  iterator erase(iterator pos);
+
+  // Returns true if the element is in the sequence, and false
+  // otherwise.
+  bool contains(const T& elem) const;
+
+  // Preallocates nodes so that the sequence can grow to n elements
+  // by appending without allocating.
+  void reserve(int n);
+
+  // Sorts the elements in the sequence using less than (<), by
+  // sorting them in an ArraySeq and moving them back.
+  void sort();
+
+  // Iterators over the elements, for range-for loops
+  iterator begin();
+  iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
+
+private:
+
+  // first and last nodes (nullptr if empty)
+  Node* head = nullptr;
+  Node* tail = nullptr;
+
+  // number of elements (across all nodes)
+  int count = 0;
+
+  // node storage
+  NodePool<Node> nodes;
+
+  // helper to return the node holding the element at the index
+  // (which must be valid) and its offset in the node, walking from
+  // the closer end of the list
+  Node* locate(int index, int& offset) const;
+
+  // helper to allocate an empty node and link it between prev and
+  // next (either may be null)
+  Node* add_node(Node* prev, Node* next);
+
+  // helper to unlink and release an (already emptied) node
+  void remove_node(Node* node);
+
+  // helper to move n constructed elements from src into raw storage
+  // at dst, leaving src as raw storage
+  static void relocate(T* src, int n, T* dst);
+
+  // helper to move elem in at the offset of the node, splitting the
+  // node first if it is full
+  T& insert_at(Node* node, int offset, T&& elem);
+
+  // helper to remove the element at the offset of the node, merging
+  // the node with the next one if it becomes nearly empty. Returns an
+  // iterator to the element after the removed one.
+  iterator erase_at(Node* node, int offset);
+
+  // helper to destroy the elements and release the nodes
+  void make_empty();
+
+};
+
+
+template<typename T, int NodeCap>
+std::ostream& operator<<(std::ostream& stream, const UnrolledSeq<T, NodeCap>& seq)
+{
+  bool first = true;
+  for(const T& elem : seq)
+  {
+    if(not first)
+      stream << ", ";
+    stream << elem;
+    first = false;
+  }
+  return stream;
+}
+
+
+// Default constructor
+template<typename T, int NodeCap>
+UnrolledSeq<T, NodeCap>::UnrolledSeq()
+{
+}
+
+// Copy constructor
+template<typename T, int NodeCap>
+UnrolledSeq<T, NodeCap>::UnrolledSeq(const UnrolledSeq& rhs)
+{
+  *this = rhs;
+}
+
+// Move constructor
+template<typename T, int NodeCap>
+UnrolledSeq<T, NodeCap>::UnrolledSeq(UnrolledSeq&& rhs)
+{
+  *this = std::move(rhs);
+}
+
+// Copy assignment operator (the copy's nodes are filled completely)
+template<typename T, int NodeCap>
+UnrolledSeq<T, NodeCap>& UnrolledSeq<T, NodeCap>::operator=(const UnrolledSeq& rhs)
+{
+  if(this != &rhs)
+  {
+    make_empty();
+    reserve(rhs.count);
+    for(const T& elem : rhs)
+      emplace(count, elem);
+  }
+  return *this;
+}
+
+// Move assignment operator
+template<typename T, int NodeCap>
+UnrolledSeq<T, NodeCap>& UnrolledSeq<T, NodeCap>::operator=(UnrolledSeq&& rhs)
+{
+  if(this != &rhs)
+  {
+    make_empty();
+    // the nodes move with their pool
+    nodes = std::move(rhs.nodes);
+    head = rhs.head;
+    tail = rhs.tail;
+    count = rhs.count;
+    rhs.head = rhs.tail = nullptr;
+    rhs.count = 0;
+  }
+  return *this;
+}
+
+// Destructor
+template<typename T, int NodeCap>
+UnrolledSeq<T, NodeCap>::~UnrolledSeq()
+{
+  make_empty();
+}
+
+// Returns the number of elements in the sequence
+template<typename T, int NodeCap>
+int UnrolledSeq<T, NodeCap>::size() const
+{
+  return count;
+}
+
+// Tests if the sequence is empty
+template<typename T, int NodeCap>
+bool UnrolledSeq<T, NodeCap>::empty() const
+{
+  return count == 0;
+}
+
+// Returns a reference to the element at the index in the sequence.
+// Throws out_of_range if index is invalid.
+template<typename T, int NodeCap>
+T& UnrolledSeq<T, NodeCap>::operator[](int index)
+{
+  if(index >= count or index < 0)
+    throw std::out_of_range("Out of range in the [] nonconst");
+  int offset = 0;
+  Node* node = locate(index, offset);
+  return node->items()[offset];
+}
+
+// Returns a constant address to the element at the index in the
+// sequence. Throws out_of_range if index is invalid.
+template<typename T, int NodeCap>
+const T& UnrolledSeq<T, NodeCap>::operator[](int index) const
+{
+  if(index >= count or index < 0)
+    throw std::out_of_range("Out of range in the [] const");
+  int offset = 0;
+  Node* node = locate(index, offset);
+  return node->items()[offset];
+}
+
+// Extends the sequence by inserting the element at the given index.
+// Throws out_of_range if the index is invalid.
+template<typename T, int NodeCap>
+void UnrolledSeq<T, NodeCap>::insert(const T& elem, int index)
+{
+  emplace(index, elem);
+}
+
+// Extends the sequence by moving the element in at the given index.
+// Throws out_of_range if the index is invalid.
+template<typename T, int NodeCap>
+void UnrolledSeq<T, NodeCap>::insert(T&& elem, int index)
+{
+  emplace(index, std::move(elem));
+}
+
+// Constructs an element at the given index. Appending (or prepending)
+// to a full end node starts a new node instead of splitting it, so a
+// sequence built in order has full nodes. Throws out_of_range if the
+// index is invalid.
+template<typename T, int NodeCap>
+template<typename... Args>
+T& UnrolledSeq<T, NodeCap>::emplace(int index, Args&&... args)
+{
+  if(index > count or index < 0)
+    throw std::out_of_range("Out of range in insert");
+
+  // the arguments may refer into the sequence, which the shifts
+  // below would invalidate, so the element is built first
+  T elem(std::forward<Args>(args)...);
+
+  if(index == count)
+  {
+    if(tail == nullptr or tail->count == NodeCap)
+      add_node(tail, nullptr);
+    return insert_at(tail, tail->count, std::move(elem));
+  }
+  if(index == 0 and head->count == NodeCap)
+  {
+    add_node(nullptr, head);
+    return insert_at(head, 0, std::move(elem));
+  }
+  int offset = 0;
+  Node* node = locate(index, offset);
+  return insert_at(node, offset, std::move(elem));
+}
+
+// Shrinks the sequence by removing the element at the index in the
+// sequence. Throws out_of_range if index is invalid.
+template<typename T, int NodeCap>
+void UnrolledSeq<T, NodeCap>::erase(int index)
+{
+  if(index >= count or index < 0)
+    throw std::out_of_range("Out of range in erase");
+  int offset = 0;
+  Node* node = locate(index, offset);
+  erase_at(node, offset);
+}
+
+// Removes the element at the iterator and returns an iterator to the
+// element after it.
+template<typename T, int NodeCap>
+typename UnrolledSeq<T, NodeCap>::iterator UnrolledSeq<T, NodeCap>::erase(iterator pos)
+{
+  return erase_at(pos.node, pos.offset);
+}
+
+// Returns true if the element is in the sequence, and false
+// otherwise.
+template<typename T, int NodeCap>
+bool UnrolledSeq<T, NodeCap>::contains(const T& elem) const
+{
+  for(Node* node = head; node != nullptr; node = node->next)
+  {
+    const T* items = node->items();
+    for(int i = 0; i < node->count; ++i)
+      if(items[i] == elem)
+        return true;
+  }
+  return false;
+}
+
+// Preallocates nodes for appending up to n elements
+template<typename T, int NodeCap>
+void UnrolledSeq<T, NodeCap>::reserve(int n)
+{
+  if(n > count)
+    nodes.reserve((n - count + NodeCap - 1) / NodeCap);
+}
+
+// Sorts by moving the elements into an ArraySeq (which picks radix
+// sort or introsort), sorting, and moving them back in order
+template<typename T, int NodeCap>
+void UnrolledSeq<T, NodeCap>::sort()
+{
+  if(count < 2)
+    return;
+  ArraySeq<T> sorted;
+  sorted.reserve(count);
+  for(T& elem : *this)
+    sorted.insert(std::move(elem), sorted.size());
+  sorted.sort();
+  int i = 0;
+  for(T& elem : *this)
+    elem = std::move(sorted.at_unchecked(i++));
+}
+
+// Iterators over the elements
+template<typename T, int NodeCap>
+typename UnrolledSeq<T, NodeCap>::iterator UnrolledSeq<T, NodeCap>::begin()
+{
+  return iterator(head, 0);
+}
+
+template<typename T, int NodeCap>
+typename UnrolledSeq<T, NodeCap>::iterator UnrolledSeq<T, NodeCap>::end()
+{
+  return iterator(nullptr, 0);
+}
+
+template<typename T, int NodeCap>
+typename UnrolledSeq<T, NodeCap>::const_iterator UnrolledSeq<T, NodeCap>::begin() const
+{
+  return const_iterator(head, 0);
+}
+
+template<typename T, int NodeCap>
+typename UnrolledSeq<T, NodeCap>::const_iterator UnrolledSeq<T, NodeCap>::end() const
+{
+  return const_iterator(nullptr, 0);
+}
+
+// Returns the node holding the element at the index and its offset,
+// walking whole nodes from the closer end
+template<typename T, int NodeCap>
+typename UnrolledSeq<T, NodeCap>::Node* UnrolledSeq<T, NodeCap>::locate(int index, int& offset) const
+{
+  Node* node;
+  if(index < count / 2)
+  {
+    node = head;
+    while(index >= node->count)
+    {
+      index -= node->count;
+      node = node->next;
+    }
+    offset = index;
+  }
+  else
+  {
+    // base is the index of the element just past node
+    int base = count;
+    node = tail;
+    while(index < base - node->count)
+    {
+      base -= node->count;
+      node = node->prev;
+    }
+    offset = index - (base - node->count);
+  }
+  return node;
+}
+
+// Allocates an empty node and links it between prev and next
+template<typename T, int NodeCap>
+typename UnrolledSeq<T, NodeCap>::Node* UnrolledSeq<T, NodeCap>::add_node(Node* prev, Node* next)
+{
+  Node* node = new (nodes.allocate()) Node;
+  node->prev = prev;
+  node->next = next;
+  node->count = 0;
+  if(prev == nullptr)
+    head = node;
+  else
+    prev->next = node;
+  if(next == nullptr)
+    tail = node;
+  else
+    next->prev = node;
+  return node;
+}
+
+// Unlinks and releases an empty node
+template<typename T, int NodeCap>
+void UnrolledSeq<T, NodeCap>::remove_node(Node* node)
+{
+  if(node->prev == nullptr)
+    head = node->next;
+  else
+    node->prev->next = node->next;
+  if(node->next == nullptr)
+    tail = node->prev;
+  else
+    node->next->prev = node->prev;
+  nodes.deallocate(node);
+}
+
+// Moves n elements from src into raw storage at dst (memcpy for
+// bitwise movable types)
+template<typename T, int NodeCap>
+void UnrolledSeq<T, NodeCap>::relocate(T* src, int n, T* dst)
+{
+  if constexpr (is_bitwise_movable<T>::value)
+    std::memcpy(static_cast<void*>(dst), src, n * sizeof(T));
+  else
+  {
+    std::uninitialized_move(src, src + n, dst);
+    std::destroy(src, src + n);
+  }
+}
+
+// Moves elem in at the offset, splitting a full node in half first
+template<typename T, int NodeCap>
+T& UnrolledSeq<T, NodeCap>::insert_at(Node* node, int offset, T&& elem)
+{
+  if(node->count == NodeCap)
+  {
+    const int half = NodeCap / 2;
+    Node* right = add_node(node, node->next);
+    relocate(node->items() + half, NodeCap - half, right->items());
+    right->count = NodeCap - half;
+    node->count = half;
+    if(offset > half)
+    {
+      node = right;
+      offset -= half;
+    }
+  }
+
+  T* items = node->items();
+  int n = node->count;
+  if(offset == n)
+    new (items + n) T(std::move(elem));
+  else if constexpr (is_bitwise_movable<T>::value)
+  {
+    std::memmove(static_cast<void*>(items + offset + 1), items + offset,
+                 (n - offset) * sizeof(T));
+    new (items + offset) T(std::move(elem));
+  }
+  else
+  {
+    new (items + n) T(std::move(items[n - 1]));
+    std::move_backward(items + offset, items + n - 1, items + n);
+    items[offset] = std::move(elem);
+  }
+  ++node->count;
+  ++count;
+  return items[offset];
+}
+
+// Removes the element at the offset, then releases the node if it is
+// empty or pulls the next node's elements into it if both fit in one
+// node and this one has dropped below a quarter full
+template<typename T, int NodeCap>
+typename UnrolledSeq<T, NodeCap>::iterator UnrolledSeq<T, NodeCap>::erase_at(Node* node, int offset)
+{
+  T* items = node->items();
+  int n = node->count;
+  if constexpr (is_bitwise_movable<T>::value)
+  {
+    std::destroy_at(items + offset);
+    std::memmove(static_cast<void*>(items + offset), items + offset + 1,
+                 (n - offset - 1) * sizeof(T));
+  }
+  else
+  {
+    std::move(items + offset + 1, items + n, items + offset);
+    std::destroy_at(items + n - 1);
+  }
+  --node->count;
+  --count;
+
+  if(node->count == 0)
+  {
+    Node* next = node->next;
+    remove_node(node);
+    return iterator(next, 0);
+  }
+
+  Node* next = node->next;
+  if(node->count < NodeCap / 4 and next != nullptr and
+     node->count + next->count <= NodeCap)
+  {
+    relocate(next->items(), next->count, items + node->count);
+    node->count += next->count;
+    next->count = 0;
+    remove_node(next);
+  }
+
+  if(offset == node->count)
+    return iterator(node->next, 0);
+  return iterator(node, offset);
+}
+
+// Destroys the elements and releases the nodes
+template<typename T, int NodeCap>
+void UnrolledSeq<T, NodeCap>::make_empty()
+{
+  Node* node = head;
+  while(node != nullptr)
+  {
+    Node* next = node->next;
+    std::destroy(node->items(), node->items() + node->count);
+    nodes.deallocate(node);
+    node = next;
+  }
+  head = tail = nullptr;
+  count = 0;
+}
+
+// UnrolledSeq with the default node size, as a one-parameter template
+// for template template parameters (such as LinkedMap's Seq)
+template<typename T>
+using UnrolledSeq64 = UnrolledSeq<T>;
+
+static_assert(is_sequence<UnrolledSeq<int>, int>::value and
+              has_static_dispatch<UnrolledSeq<int>>::value,
+              "UnrolledSeq must satisfy the Sequence interface statically");
+
+
+#endif
@@ -38,12 +38,14 @@ void load_shuffled(Sequence<int>& s, int n, int shuffles)
 
 void load_in_order(Sequence<int>& s, int n)
 {
+  s.reserve(s.size() + n);
   for (int i = 0; i < n; ++i)
     s.insert(i+1, i);
 }
 
 void load_reverse_order(Sequence<int>& s, int n)
 {
+  s.reserve(s.size() + n);
   for (int i = 0; i < n; ++i)
     s.insert(n-i, i);
 }